@@ -1,10 +1,32 @@
 import os
 import subprocess
+import struct
 import math
 import dubins
 import numpy as np
 from abc import ABCMeta, abstractmethod
 
+import TripathClass
+
+def read_tripath_record(data, offset=0):
+    """Reads one binary result record written by 'setut -binary' (see setut_UxAS.cpp).
+    Returns (tag, status, length, values, next_offset); values holds the path points
+    as an (n,2) array for PATH records and the lengths for LENS records."""
+    tag = data[offset:offset+4]
+    status, count, length = struct.unpack_from('=iif', data, offset+4)
+    offset += 16
+    values = None
+    if tag == b'PATH':
+        values = np.frombuffer(data[offset:offset+8*count], dtype=np.float32).reshape(count, 2).astype(float)
+        offset += 8*count
+    elif tag == b'LENS':
+        values = np.frombuffer(data[offset:offset+4*count], dtype=np.float32).astype(float)
+        offset += 4*count
+    elif tag == b'ERR ':
+        values = data[offset:offset+count]
+        offset += count
+    return tag, status, length, values, offset
+
 class Pathing(object):
 
     """A class for pathing of PISR Vehicles."""
@@ -202,6 +224,8 @@ class Tripath_Pathing(Pathing):
         self.nfz = nfz             #tells Tripath which no-fly zone to use (an integer)
         self.trajectory = []        
         self.nfz_impact = 0      #ratio of average travel distance with nfz to w/out nfz
+        self.lct = None          #in-process LCT of the map (see get_lct)
+        self.lct_failed = False
         
 
     def print_pathing_data(self):
@@ -210,6 +234,16 @@ class Tripath_Pathing(Pathing):
         print '            NFZ:', self.nfz
         print '            NFZ Impact Rating:', self.nfz_impact 
 
+    def get_lct(self):
+        #The LCT of the map is built once and queried in-process when libtripath is available,
+        #otherwise None is returned and every query runs the setut executable
+        if self.lct is None and not self.lct_failed:
+            try:
+                self.lct = TripathClass.Tripath_LCT(self.map, self.nfz)
+            except (OSError, IOError):
+                self.lct_failed = True
+        return self.lct
+
     def get_path(self, vehicle):
 
         x0 = vehicle.location.location[0]
@@ -219,17 +253,15 @@ class Tripath_Pathing(Pathing):
         y1 = vehicle.routing.destination.location[1]
 
         #Cacluate the path to the task
-        FNULL = open(os.devnull, 'w')   #This prevents a terminal window from popping up each time Tripath is called
-        subprocess.call('/home/chris/Research/PISR_Sim_NGpp/Tripath_custom/bin/./setut {} {} {} {} {} {}'.format(x0, y0, x1, y1, vehicle.pathing.map, vehicle.pathing.nfz),
-            cwd='/home/chris/Research/PISR_Sim_NGpp/Tripath_custom/bin/', stdout=FNULL, shell=True)
-        path_data = np.genfromtxt('/home/chris/Research/PISR_Sim_NGpp/Tripath_custom/bin/path.txt', delimiter = ",")  #path_data is the trajectory data
-        xPath = path_data[:,0]
-        yPath = path_data[:,1]
-
-        #Calculate the length of the path
-        path_length = 0
-        for ind, entry in enumerate(xPath[0:-1]):
-            path_length = path_length + math.sqrt(math.pow(xPath[ind+1]-xPath[ind], 2)+math.pow(yPath[ind+1]-yPath[ind], 2)) 
+        lct = self.get_lct()
+        if lct is not None:
+            path_data, path_length = lct.path(x0, y0, x1, y1)  #path_data is the trajectory data
+        else:
+            #returned on stdout as a binary record with the exact length and the points
+            FNULL = open(os.devnull, 'w')   #This prevents a terminal window from popping up each time Tripath is called
+            output = subprocess.check_output('/home/chris/Research/PISR_Sim_NGpp/Tripath_custom/bin/./setut -binary {} {} {} {} {} {}'.format(x0, y0, x1, y1, vehicle.pathing.map, vehicle.pathing.nfz),
+                cwd='/home/chris/Research/PISR_Sim_NGpp/Tripath_custom/bin/', stderr=FNULL, shell=True)
+            _, _, path_length, path_data, _ = read_tripath_record(output)  #path_data is the trajectory data
 
         #update vehicle states
         self.trajectory = path_data        
@@ -249,28 +281,26 @@ class Tripath_Pathing(Pathing):
         x0 = vehicle.location.location[0]
         y0 = vehicle.location.location[1]
 
-        #For every candidate task...        
-        for index, task in enumerate(task_vector): 
-            
-            #Coordinates of candidate task
-            x1 = task.location[0]
-            y1 = task.location[1]
-
-            #Cacluate the path to the task
+        #A single Tripath multi-goal search computes the path lengths to every candidate task
+        lct = self.get_lct()
+        if lct is not None:
+            dists = lct.goal_lengths(x0, y0, [task.location[0:2] for task in task_vector])
+        else:
+            coords = ' '.join('{} {}'.format(task.location[0], task.location[1]) for task in task_vector)
             FNULL = open(os.devnull, 'w')   #This prevents a terminal window from popping up each time Tripath is called
-            subprocess.call('/home/chris/Research/PISR_Sim_NGpp/Tripath_custom/bin/./setut {} {} {} {} {} {}'.format(x0, y0, x1, y1, vehicle.pathing.map, vehicle.pathing.nfz),
-                cwd='/home/chris/Research/PISR_Sim_NGpp/Tripath_custom/bin/', stdout=FNULL, shell=True)
-            path_data = np.genfromtxt('/home/chris/Research/PISR_Sim_NGpp/Tripath_custom/bin/path.txt', delimiter = ",")
-            xPath = path_data[:,0]
-            yPath = path_data[:,1]
+            output = subprocess.check_output('/home/chris/Research/PISR_Sim_NGpp/Tripath_custom/bin/./setut -binary -goals {} {} {} {} {}'.format(vehicle.pathing.map, vehicle.pathing.nfz, x0, y0, coords),
+                cwd='/home/chris/Research/PISR_Sim_NGpp/Tripath_custom/bin/', stderr=FNULL, shell=True)
+            dists = read_tripath_record(output)[3]
 
-            #Calculate the length of the path
-            dist = 0
-            for ind, entry in enumerate(xPath[0:-1]):
-                dist = dist + math.sqrt(math.pow(xPath[ind+1]-xPath[ind], 2)+math.pow(yPath[ind+1]-yPath[ind], 2))
+        #Tripath reports -1 for a task it cannot reach, which must not rank as the closest one
+        dists = np.array(dists, dtype=float)
+        dists[dists < 0] = float('inf')
+
+        #For every candidate task...        
+        for index, task in enumerate(task_vector): 
 
             #Convert distance to travel time
-            time = dist/vehicle.speed
+            time = dists[index]/vehicle.speed
             
             #Save the travel time to each task
             times_and_headings.append([task.ID, time, 0])
@@ -297,32 +327,24 @@ class Tripath_Pathing(Pathing):
         D_without_nfz = np.sum(distanceMatrix)/((distanceMatrix.shape[0]**2)-distanceMatrix.shape[0])   #don't divide by diaganol entries, which are zero
 
         #Second, calculate the average distance between all tasks taking into account the NFZ (Use Tripath)
-        D_array = []
-        for start_task in task_vector:  #for every task...
-            for end_task in task_vector:  #to every task...
-                #Coordinates of starting task
-                x0 = start_task.location[0]
-                y0 = start_task.location[1]
-
-                #Coordinate of destination task
-                x1 = end_task.location[0]
-                y1 = end_task.location[1]
-
-                #Caclulate distance between start and end task
-                FNULL = open(os.devnull, 'w')   #This prevents a terminal window from popping up each time Tripath is called
-                # subprocess.call('../../Tripath_custom/bin/./setut {} {} {} {} {} {}'.format(x0, y0, x1, y1, pathing_data[1], pathing_data[2]),
-                #     cwd='../../Tripath_custom/bin/', stdout=FNULL, shell=True)
-                subprocess.call('/home/chris/Research/PISR_Sim_NGpp/Tripath_custom/bin/./setut {} {} {} {} {} {}'.format(x0, y0, x1, y1, pathing_data[1], pathing_data[2]),
-                    cwd='/home/chris/Research/PISR_Sim_NGpp/Tripath_custom/bin/', stdout=FNULL, shell=True)
-                path_data = np.genfromtxt('/home/chris/Research/PISR_Sim_NGpp/Tripath_custom/bin/path.txt', delimiter = ",")
-                xPath = path_data[:,0]
-                yPath = path_data[:,1]
-                dist = 0
-                for ind, entry in enumerate(xPath[0:-1]):
-                    dist = dist + math.sqrt(math.pow(xPath[ind+1]-xPath[ind], 2)+math.pow(yPath[ind+1]-yPath[ind], 2))
-                D_array.append(dist)
-        D_array = np.array(D_array)        
-        D_with_nfz = np.sum(D_array)/(D_array.shape[0]-len(task_vector))   #don't divide by the zero entries of task x to task x
+        #A single Tripath batch computes the whole task-to-task distance matrix
+        lct = self.get_lct()
+        if lct is not None:
+            D_array = lct.matrix([task.location[0:2] for task in task_vector]).flatten()
+        else:
+            coords = ' '.join('{} {}'.format(task.location[0], task.location[1]) for task in task_vector)
+            FNULL = open(os.devnull, 'w')   #This prevents a terminal window from popping up each time Tripath is called
+            output = subprocess.check_output('/home/chris/Research/PISR_Sim_NGpp/Tripath_custom/bin/./setut -binary -matrix {} {} {}'.format(pathing_data[1], pathing_data[2], coords),
+                cwd='/home/chris/Research/PISR_Sim_NGpp/Tripath_custom/bin/', stderr=FNULL, shell=True)
+            D_array = read_tripath_record(output)[3]
+
+        #Tripath reports -1 for pairs of tasks the NFZ disconnects, which are left out of the average
+        reached = np.asarray(D_array) >= 0
+        unreachable = np.count_nonzero(~reached)
+        if unreachable > 0:
+            print '      {} task pairs are unreachable with the NFZ'.format(unreachable)
+        pairs = np.count_nonzero(reached)-len(task_vector)   #don't divide by the zero entries of task x to task x
+        D_with_nfz = np.sum(np.asarray(D_array)[reached])/pairs if pairs > 0 else float('inf')
         
         #calculate nfz impact rating and save
         self.nfz_impact = D_with_nfz/D_without_nfz
@@ -0,0 +1,169 @@
+import os
+import math
+import ctypes
+import numpy as np
+
+#Default location of the Tripath C library (built by 'make' in Tripath_custom/linux) and of the map files
+TRIPATH_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'Tripath_custom')
+TRIPATH_LIB = os.environ.get('TRIPATH_LIB', os.path.join(TRIPATH_DIR, 'lib', 'libtripath.so'))
+TRIPATH_MAPS = os.environ.get('SETUT_MAPS', os.path.join(TRIPATH_DIR, 'maps'))
+
+_lib = None
+
+def load_tripath_library(filename=TRIPATH_LIB):
+    """Loads libtripath once and declares the C interface of tripath.h. Returns None if it cannot be loaded."""
+    global _lib
+    if _lib is not None:
+        return _lib
+    try:
+        lib = ctypes.CDLL(filename)
+    except OSError:
+        return None
+    c_float_p = ctypes.POINTER(ctypes.c_float)
+    lib.tp_version.restype = ctypes.c_int
+    lib.tp_create.argtypes = [c_float_p, ctypes.c_int, ctypes.c_double]
+    lib.tp_create.restype = ctypes.c_void_p
+    lib.tp_load.argtypes = [ctypes.c_char_p, ctypes.c_int]
+    lib.tp_load.restype = ctypes.c_void_p
+    lib.tp_save_snapshot.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+    lib.tp_free.argtypes = [ctypes.c_void_p]
+    lib.tp_free.restype = None
+    lib.tp_insert_polygon.argtypes = [ctypes.c_void_p, c_float_p, ctypes.c_int]
+    lib.tp_remove_polygon.argtypes = [ctypes.c_void_p, ctypes.c_int]
+    lib.tp_move_polygon.argtypes = [ctypes.c_void_p, ctypes.c_int, c_float_p, ctypes.c_int]
+    lib.tp_refine.argtypes = [ctypes.c_void_p]
+    lib.tp_refine_threads.argtypes = [ctypes.c_void_p, ctypes.c_int]
+    lib.tp_landmarks.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_float]
+    lib.tp_junction_graph.argtypes = [ctypes.c_void_p, ctypes.c_int]
+    lib.tp_frozen_mesh.argtypes = [ctypes.c_void_p, ctypes.c_int]
+    lib.tp_search_mode.argtypes = [ctypes.c_void_p, ctypes.c_int]
+    lib.tp_expanded_nodes.argtypes = [ctypes.c_void_p, ctypes.c_int]
+    lib.tp_path_length.argtypes = [ctypes.c_void_p] + [ctypes.c_float]*5
+    lib.tp_path_length.restype = ctypes.c_float
+    lib.tp_path.argtypes = [ctypes.c_void_p] + [ctypes.c_float]*6 + [c_float_p, ctypes.c_int, c_float_p]
+    lib.tp_lengths.argtypes = [ctypes.c_void_p, c_float_p, ctypes.c_int, ctypes.c_float, c_float_p]
+    lib.tp_goal_lengths.argtypes = [ctypes.c_void_p, ctypes.c_float, ctypes.c_float, c_float_p, ctypes.c_int, ctypes.c_float, c_float_p]
+    lib.tp_radius_lengths.argtypes = [ctypes.c_void_p] + [ctypes.c_float]*4 + [c_float_p, ctypes.c_int, c_float_p]
+    lib.tp_cache.argtypes = [ctypes.c_void_p, ctypes.c_int]
+    _lib = lib
+    return _lib
+
+def _floats(values):
+    a = np.ascontiguousarray(values, dtype=np.float32).flatten()
+    return a, a.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
+
+
+class Tripath_LCT(object):
+
+    """An LCT kept in memory by libtripath: the mesh is built once and then queried in-process.
+    threads sets the threads of the refinement passes over the whole mesh, 0 using one per core."""
+
+    def __init__(self, map_name, nfz, radius=85.0, threads=1):
+        self.lib = load_tripath_library()
+        if self.lib is None:
+            raise OSError('Tripath library not found: {}'.format(TRIPATH_LIB))
+        filename = map_name if ('/' in map_name or '.' in map_name) else os.path.join(TRIPATH_MAPS, map_name + '.dcdt')
+        self.handle = self.lib.tp_load(filename.encode(), int(nfz))
+        if not self.handle:
+            raise IOError('Could not load map file {}'.format(filename))
+        self.radius = radius
+        self.lib.tp_refine_threads(self.handle, int(threads))
+        self.lib.tp_refine(self.handle)
+
+    def __del__(self):
+        if getattr(self, 'handle', None):
+            self.lib.tp_free(self.handle)
+            self.handle = None
+
+    def insert_polygon(self, xy):
+        a, p = _floats(xy)
+        return self.lib.tp_insert_polygon(self.handle, p, len(a)//2)
+
+    def remove_polygon(self, polygon_id):
+        return self.lib.tp_remove_polygon(self.handle, polygon_id) == 1
+
+    def move_polygon(self, polygon_id, xy):
+        """Replaces a polygon, e.g. a no-fly zone that moved, and returns its new id (-1 if the id is not valid).
+        Cached paths the change cannot affect are kept, and only the affected ones are searched again,
+        each one from scratch."""
+        a, p = _floats(xy)
+        return self.lib.tp_move_polygon(self.handle, polygon_id, p, len(a)//2)
+
+    def landmarks(self, n, radius=None):
+        """Precomputes n landmarks speeding up path_length() and path() for any radius; returns how many
+        were found. Queries with the given radius (the one of this LCT by default) or larger ones also
+        skip the regions from which the goal cannot be reached.
+        They are discarded when polygons are inserted or removed."""
+        return self.lib.tp_landmarks(self.handle, int(n), self.radius if radius is None else radius)
+
+    def junction_graph(self, on=True):
+        """Builds (or discards) the junction graph restricting path queries to routes between junctions;
+        returns the number of junctions. It is discarded when polygons are inserted or removed."""
+        return self.lib.tp_junction_graph(self.handle, 1 if on else 0)
+
+    def frozen_mesh(self, on=True):
+        """Builds (or discards) the compact copy of the mesh that the channel search of path_length() and
+        path() expands, finding the same paths faster; returns the number of triangles. The copy is kept
+        in addition to the mesh, which the funnel still uses, taking about 80 bytes more per triangle.
+        It is discarded when polygons are inserted or removed."""
+        return self.lib.tp_frozen_mesh(self.handle, 1 if on else 0)
+
+    def search_mode(self, bidirectional=True):
+        """Makes path_length() and path() search from both endpoints (or only from the start, the default)"""
+        return self.lib.tp_search_mode(self.handle, 1 if bidirectional else 0) == 1
+
+    def expanded_nodes(self):
+        """(forward, backward) search nodes expanded by the last path_length() or path() query that was searched"""
+        return self.lib.tp_expanded_nodes(self.handle, 0), self.lib.tp_expanded_nodes(self.handle, 1)
+
+    def cache(self, capacity):
+        """Empties the cache of query results and sets its capacity (0 disables it);
+        returns how many queries the cache answered so far"""
+        return self.lib.tp_cache(self.handle, int(capacity))
+
+    def path_length(self, x0, y0, x1, y1):
+        """Exact length of the path, -1 if there is none"""
+        return self.lib.tp_path_length(self.handle, x0, y0, x1, y1, self.radius)
+
+    def path(self, x0, y0, x1, y1, dang=math.radians(10.0)):
+        """Returns (points as an (n,2) array, exact length); no points and -1 if there is no path"""
+        length = ctypes.c_float()
+        n = self.lib.tp_path(self.handle, x0, y0, x1, y1, self.radius, dang, None, 0, ctypes.byref(length))
+        if n < 0:
+            return np.zeros((0, 2)), -1.0
+        pts, p = _floats(np.zeros(2*n))
+        self.lib.tp_path(self.handle, x0, y0, x1, y1, self.radius, dang, p, n, None)
+        return pts.reshape(n, 2).astype(float), length.value
+
+    def lengths(self, queries):
+        """Lengths of the paths of the given (x0, y0, x1, y1) queries, solved in parallel"""
+        q, qp = _floats(queries)
+        lens, lp = _floats(np.zeros(len(q)//4))
+        self.lib.tp_lengths(self.handle, qp, len(lens), self.radius, lp)
+        return lens.astype(float)
+
+    def goal_lengths(self, x0, y0, goals):
+        """Lengths of the paths from (x0, y0) to every (x, y) goal, with a single multi-goal search"""
+        g, gp = _floats(goals)
+        lens, lp = _floats(np.zeros(len(g)//2))
+        self.lib.tp_goal_lengths(self.handle, x0, y0, gp, len(lens), self.radius, lp)
+        return lens.astype(float)
+
+    def radius_lengths(self, x0, y0, x1, y1, radii):
+        """Lengths of the paths from (x0, y0) to (x1, y1) for each clearance radius, e.g. of vehicles
+        with different turn radii; radii larger than one without path are not searched, and the
+        channel of the smallest radius is reused where passable, so a length may be slightly longer
+        than the one of path_length()"""
+        r, rp = _floats(radii)
+        lens, lp = _floats(np.zeros(len(r)))
+        self.lib.tp_radius_lengths(self.handle, x0, y0, x1, y1, rp, len(r), lp)
+        return lens.astype(float)
+
+    def matrix(self, points):
+        """All pairwise path lengths between the given (x, y) points, zero on the diagonal"""
+        pts = np.asarray(points, dtype=float).reshape(-1, 2)
+        n = len(pts)
+        queries = np.hstack([np.repeat(pts, n, axis=0), np.tile(pts, (n, 1))])
+        D = self.lengths(queries).reshape(n, n)
+        np.fill_diagonal(D, 0.0)
+        return D
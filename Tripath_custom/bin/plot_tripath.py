@@ -5,6 +5,7 @@ pathData = np.genfromtxt('path.txt',delimiter = ",")
 xPath = pathData[:,0]
 yPath = pathData[:,1]
 
+# the mesh edges are not written by path queries, run once: setut -mesh <map> <nfz>
 cEdges = np.genfromtxt('cedges.txt',delimiter=",")
 xCEdges = cEdges[:,0]
 yCEdges = cEdges[:,1]
@@ -24,6 +24,8 @@ class GsManagerBase : public GsShared
     virtual void* alloc ()=0;
     virtual void* alloc ( const void* obj )=0;
     virtual void free ( void* obj )=0;
+    /*! Frees at once all objects allocated by the manager, if supported, returning false otherwise */
+    virtual bool free_all () { return false; }
     virtual void output ( GsOutput& /*o*/, const void* /*obj*/ ) { }
     virtual void input ( GsInput& /*i*/, void* /*obj*/ ) { }
     virtual int compare ( const void* /*obj1*/, const void* /*obj2*/ ) { return 0; }
@@ -0,0 +1,115 @@
+/*=======================================================================
+   Copyright 2010 Marcelo Kallmann. All Rights Reserved.
+   This software is distributed for noncommercial use only, without
+   any warranties, and provided that all copies contain the full copyright
+   notice licence.txt located at the base folder of the distribution.
+  =======================================================================*/
+
+# ifndef GS_POOL_H
+# define GS_POOL_H
+
+/** \file gs_pool.h
+ * Slab allocation of objects of one class */
+
+# include <new>
+# include <type_traits>
+# include <gsim/gs_array.h>
+# include <gsim/gs_manager.h>
+
+/*! GsPool allocates objects of class X in slabs of consecutive objects, which grow with the
+    pool up to a maximum size, instead of allocating each object from the heap. Freed objects
+    are destructed and their memory is kept in a free list, to be reused by the next
+    allocations. clear() releases all slabs at once without calling the destructors of the
+    objects still allocated, which is only correct for classes without destructor or after
+    all objects were freed. */
+template <class X>
+class GsPool
+ { private :
+    union Slot { Slot* next; typename std::aligned_storage<sizeof(X),std::alignment_of<X>::value>::type obj; };
+    GsArray<Slot*> _slabs;
+    Slot* _free;     // list of free slots
+    int _size;       // allocated objects
+    int _capacity;   // slots in all slabs
+    GsPool ( const GsPool& ) {}
+    void operator= ( const GsPool& ) {}
+
+    void* _slot ()
+     { if ( !_free )
+        { int n = _capacity<256? 256 : _capacity<16384? _capacity : 16384; // slab size
+          Slot* slab = new Slot[n];
+          _slabs.push() = slab;
+          _capacity += n;
+          for ( int i=n-1; i>=0; i-- ) { slab[i].next=_free; _free=slab+i; } // in address order
+        }
+       Slot* s = _free;
+       _free = s->next;
+       _size++;
+       return (void*)s;
+     }
+
+   public :
+    /*! Creates an empty pool, the first slab is only allocated when needed */
+    GsPool () { _free=0; _size=_capacity=0; }
+
+    /*! Releases all slabs, see clear() */
+   ~GsPool () { clear(); }
+
+    /*! Returns the number of allocated objects */
+    int size () const { return _size; }
+
+    /*! Returns the number of objects that fit in the allocated slabs */
+    int capacity () const { return _capacity; }
+
+    /*! Allocates an object with its default constructor */
+    X* alloc () { return new(_slot()) X; }
+
+    /*! Allocates a copy of x */
+    X* alloc ( const X& x ) { return new(_slot()) X(x); }
+
+    /*! Destructs x, which must have been allocated by this pool, and keeps its memory for reuse */
+    void free ( X* x )
+     { x->~X();
+       Slot* s = (Slot*)(void*)x;
+       s->next = _free;
+       _free = s;
+       _size--;
+     }
+
+    /*! Releases all slabs, invalidating all objects. The objects still allocated are not destructed. */
+    void clear ()
+     { for ( int i=0; i<_slabs.size(); i++ ) delete[] _slabs[i];
+       _slabs.size ( 0 );
+       _slabs.compress ();
+       _free = 0;
+       _size = _capacity = 0;
+     }
+ };
+
+/*! GsPoolManager is a GsManager allocating the objects from a GsPool, so that many small
+    objects, as the elements of a mesh, are allocated in slabs instead of one by one.
+    The manager should not be shared between owners using free_all(). */
+template <class X>
+class GsPoolManager : public GsManager<X>
+ { private :
+    GsPool<X> _pool;
+
+   protected :
+    virtual ~GsPoolManager<X> () {}
+
+   public :
+    virtual void* alloc () { return (void*) _pool.alloc(); }
+
+    virtual void* alloc ( const void* obj ) { return (void*) _pool.alloc(*((X*)obj)); }
+
+    virtual void free ( void* obj ) { _pool.free ( (X*)obj ); }
+
+    virtual bool free_all ()
+     { if ( _pool.size()>0 && !std::is_trivially_destructible<X>::value ) return false;
+       _pool.clear ();
+       return true;
+     }
+ };
+
+//============================== end of file ===============================
+
+# endif  // GS_POOL_H
@@ -38,9 +38,13 @@ class SeDcdt : public SeTriangulator
     GsArray<SeDcdtVertex*>  _varray2; // internal buffer
     GsArray<int> _ibuffer;            // internal buffer
     bool _dcdt_changed;            // internal flag for clearance operations
+    int _version;                  // incremented at each change of the mesh
+    GsArray<float> _edits;         // boxes (xmin,ymin,xmax,ymax) of the polygons inserted or removed not yet processed, see SeLct::refine()
+    bool _editall;                 // true when the whole mesh has to be considered changed, e.g. after init()
     bool _using_domain;            // internal flag
     float _xmin, _xmax, _ymin, _ymax, _radius; // domain info
     void _construct ();
+    void _add_edit ( const GsPnt2& p, bool first );
 
    public :
 
@@ -62,6 +66,12 @@ class SeDcdt : public SeTriangulator
     /*! Returns the associated (and shared) manager pointer */
     SeDcdtManager* man () const { return (SeDcdtManager*)SeTriangulator::man(); }
 
+    /*! Returns a counter which is incremented whenever the constraints change, i.e. by
+        init(), insert_polygon() and remove_polygon() (once per call) or by loading a mesh.
+        It allows query results stored by the application to be recognized as outdated.
+        Refinements do not change it as they only subdivide the free space. */
+    int version () const { return _version; }
+
     /*! Put in the given arrays the coordinates of the constrained and
         unconstrained edges endpoints. Each two consecutive points in the
         returned arrays give the first and end points of one dge.
@@ -81,8 +91,11 @@ class SeDcdt : public SeTriangulator
         Note that the polygons ids are preserved. */
     bool save ( GsOutput& out );
 
-    /*! Destructs the current map and loads a new one */
-    bool load ( GsInput& inp );
+    /*! Destructs the current map and loads a new one. A file may describe several
+        variants of a map: polygons declared after a "variant <n>" keyword are only
+        loaded if n is equal to the given variant, and polygons declared before any
+        variant keyword are always loaded. */
+    bool load ( GsInput& inp, int variant=0 );
     
     /*! Initializes the triangulation with a domain polygon.
         The domain is considered to be the constraint polygon with id 0; and can
@@ -44,12 +44,12 @@ class SeDcdtVertex : public SeElement
 class SeDcdtEdge : public SeElement
  { public :
     GsArray<int> ids; // ids of all constraints sharing this edge
-    int nodeid;       // internally used by the optimal search algorithm
+    int nodeid;       // internally used by the optimal and multi-goal search algorithms
     float ca, cb;     // precomputed clearances (stored values have the square of each clearance)
    public :
     SE_ELEMENT_CASTED_METHODS(SeDcdtEdge,SeDcdtSymEdge);
-    SeDcdtEdge () : SeElement() { }
-    SeDcdtEdge ( const SeDcdtEdge& e ) : SeElement() { ids=e.ids; }
+    SeDcdtEdge () : SeElement() { nodeid=-1; }
+    SeDcdtEdge ( const SeDcdtEdge& e ) : SeElement() { ids=e.ids; nodeid=-1; }
     float cl ( SeDcdtSymEdge* s ) const { return s==se()? ca:cb; }
     bool border () const { return se()->vtx()->border || se()->nvtx()->border? true:false; }
     bool is_constrained() const { return ids.size()>0? true:false; }
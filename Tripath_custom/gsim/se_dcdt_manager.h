@@ -18,17 +18,28 @@
 //================================ SeDcdtManager =====================================
 
 /*! Provides the implementation of the required base class virtual methods so
-    that SeDcdt can correctly deal with the SeDcdt elements. */
+    that SeDcdt can correctly deal with the SeDcdt elements. The methods are final:
+    SeTriangulator is instantiated with this class for SeDcdt, calling them inline,
+    and derived managers can only redefine the remaining notification methods. */
 class SeDcdtManager: public SeTriangulatorManager
  { public :
-    virtual void get_vertex_coordinates ( const SeVertex* v, double& x, double & y );
-    virtual void set_vertex_coordinates ( SeVertex* v, double x, double y );
-    virtual void new_steiner_vertex_created ( SeVertex* v );
-    virtual bool is_constrained ( SeEdge* e );
-    virtual void set_unconstrained ( SeEdge* e );
-    virtual void get_constraints ( SeEdge* e, GsArray<int>& ids );
-    virtual void add_constraints ( SeEdge* e, const GsArray<int>& ids );
-    virtual void copy_constraints ( const SeEdge* e1, SeEdge* e2 );
+    virtual void get_vertex_coordinates ( const SeVertex* v, double& x, double & y ) final
+     { x = (double) ((SeDcdtVertex*)v)->p.x;
+       y = (double) ((SeDcdtVertex*)v)->p.y;
+     }
+    virtual void set_vertex_coordinates ( SeVertex* v, double x, double y ) final
+     { ((SeDcdtVertex*)v)->p.x = (float) x;
+       ((SeDcdtVertex*)v)->p.y = (float) y;
+     }
+    virtual void new_steiner_vertex_created ( SeVertex* v ) final
+     { ((SeDcdtVertex*)v)->refinement = true; }
+    virtual bool is_constrained ( SeEdge* e ) final
+     { return ((SeDcdtEdge*)e)->is_constrained(); }
+    virtual void set_unconstrained ( SeEdge* e ) final
+     { ((SeDcdtEdge*)e)->set_unconstrained(); }
+    virtual void get_constraints ( SeEdge* e, GsArray<int>& ids ) final;
+    virtual void add_constraints ( SeEdge* e, const GsArray<int>& ids ) final;
+    virtual void copy_constraints ( const SeEdge* e1, SeEdge* e2 ) final;
  };
 
 //================================ End of File ========================================
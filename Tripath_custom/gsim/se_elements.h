@@ -33,6 +33,8 @@ typedef SeElement SeFace;    //!< a face is an element
     2. pointers maintaining a circular list of the adjacent elements
        of the same type (vertices, edges or faces)
     3. an index that can be used by SeMeshBase to mark elements
+    4. an id, unique among all elements of the mesh, which can be used
+       to associate external data to elements (see SeMeshMarker)
     For attaching user-related information to an element:
     1. SeElement must be derived and all user data is declared
        inside the derived class.
@@ -42,11 +44,12 @@ typedef SeElement SeFace;    //!< a face is an element
        is not used. See also sr_class_manager.h. */
 class SeElement
  { protected :
-    SeElement () { _index=0; _symedge=0; _next=_prior=this; }
+    SeElement () { _index=0; _id=0; _symedge=0; _next=_prior=this; }
    public :
     SeBase*    se () const { return _symedge; }
     SeElement* nxt() const { return _next; }
     SeElement* pri() const { return _prior; }
+    int        id () const { return _id; }
    private :
     friend class SeMeshBase;
     friend class GsManagerBase;
@@ -54,6 +57,7 @@ class SeElement
     SeElement*  _prior;
     SeBase*     _symedge;
     semeshindex _index;
+    int         _id;
     SeElement*  _remove ();
     SeElement*  _insert ( SeElement* n );
  };
@@ -12,6 +12,8 @@
  * Computation of paths with clearance from DCDTs
  */
 
+# include <gsim/gs_heap.h>
+# include <gsim/gs_shared.h>
 # include <gsim/se_dcdt.h>
 
 //================================== DcdtClear class ========================================
@@ -41,6 +43,101 @@ class SeLct : public SeDcdt
                       GsArray<GsPnt2> fp;    // coordinates of the funnel side, including circle tangent and entrance corner
                     } _ent[4]; // 0-2: departure, 1:arrival
 
+    struct GoalSearch { GsArray<GsPnt2> pts;  // goals of a multi-goal search, empty in single-goal searches
+                        GsArray<char> st;     // goal states: 'o' open, 'l' local, 'r' reached, 'u' unreachable
+                        float* lens;          // output lengths, one per goal, -1 while no path is found
+                        GsPolygon* paths;     // optional output paths, one per goal
+                        float dang;           // angle resolution of the paths
+                        int open;             // number of goals still open
+                        int pruned;           // traversals rejected for entering a triangle of their own channel
+                        GsArray<float> lb;    // lower bound of the paths through each search node
+                        GsArray<char> leaf;   // 1 while the search node is a leaf
+                        GsHeap<int,float> bounds; // search nodes by lower bound, expanded ones are removed lazily
+                        struct Crossing { SeDcdtEdge* e; char dirs; };
+                        GsArray<Crossing> crossed; // edges expanded, indexed by edge nodeids
+                        GsArray<int> ids;     // crossing indices per edge id, used instead of nodeids with a marker
+                      } _goals;
+
+    struct Landmarks : public GsShared { float radius;         // radius used to filter traversals
+                                         int n;                // number of landmarks
+                                         GsArray<int> slot;    // index of each unconstrained edge of the free space per edge id, -1 otherwise
+                                         GsArray<int> comp;    // component per edge slot, joining the traversals with clearance for radius
+                                         GsArray<int> vslot;   // index of each vertex of the free space per vertex id, -1 otherwise
+                                         GsArray<float> dist;  // n distances per vertex slot, -1 if unreachable from the landmark
+                                       };
+    Landmarks* _lm;             // landmark distances, referenced by the query contexts sharing them
+    GsArray<float> _lmgoal;     // goal edge components, then index and goal distance bounds of each active landmark
+
+    struct JunctionGraph : public GsShared { struct Junction { SeDcdtSymEdge* s; // first edge of the junction triangle
+                                                               int c[3];         // corridor leaving by each edge: s, s->nxt(), s->nxn()
+                                                               GsPnt2 m[3];      // edge midpoints
+                                                             };
+                                             struct Corridor { int j[2];    // end junctions, j[1] is -1 for dead ends
+                                                               char k[2];   // edge of each end junction entered by the corridor
+                                                               int fst, n;  // range of the corridor triangles in faces, from j[0]
+                                                               float width; // min squared clearance of its traversals, -1 if none
+                                                               float len;   // length through the edge midpoints, between the junction edges
+                                                             };
+                                             GsArray<Junction> juncs;
+                                             GsArray<Corridor> corrs;
+                                             GsArray<SeDcdtFace*> faces; // triangles of the corridors
+                                             GsArray<int> jof, cof;      // junction and corridor index per face id, -1 if none
+                                           };
+    JunctionGraph* _jg;         // junction graph, referenced by the query contexts sharing it
+    struct JgState { int stamp; bool closed; float g; int parent, corr; };
+    GsArray<JgState> _jgstates; // route search states, per junction and entrance edge
+    GsHeap<int,float> _jgheap;  // route search queue
+    GsArray<int> _jgallow;      // faces allowed in the current search are marked with _jgstamp
+    int _jgstamp;
+    bool _jgrestrict;           // true when the search is restricted to the faces of a route
+
+    struct FrozenMesh : public GsShared { GsArray<GsPnt2> pts;          // vertex coordinates
+                                          GsArray<int> vtx;             // vertex of each half-edge, half-edge k of triangle t being 3t+k
+                                          GsArray<int> sym;             // opposite half-edge, -1 at the border
+                                          GsArray<float> cl;            // clearance of the traversal of each half-edge, see SeDcdtEdge::cl()
+                                          GsArray<char> con;            // 1 if the edge of the half-edge is constrained
+                                          GsArray<SeDcdtSymEdge*> se;   // symedge of each half-edge
+                                          GsArray<int> tri;             // triangle per face id, -1 if none
+                                        };
+    FrozenMesh* _frz;           // compact copy of the mesh expanded by the searches, referenced by query contexts
+    GsArray<int> _frzvisit;     // triangles expanded by the current search are marked with _frzstamp
+    int _frzstamp;
+    int _frzfi;                 // triangle containing the initial point
+    GsArray<int> _frzhe;        // entrance and exit half-edges of each search node
+
+    struct LocGrid : public GsShared { float x, y, cw, ch;         // origin and cell dimensions
+                                       int nx, ny;                 // number of columns and rows
+                                       GsArray<SeDcdtFace*> cells; // a face containing the center of each cell
+                                     };
+    LocGrid* _lg;               // point location grid, rebuilt with the mesh, referenced by query contexts
+
+    struct FaceSig { int v[3];  // vertex ids, starting at the lowest one
+                     char c;    // constrained edges, one bit per edge following v
+                   };
+    GsArray<FaceSig> _fsig;     // signatures of the faces at the last refinement, per face id
+    bool _incremental;          // refinement and clearances updated only around changed faces
+    bool _updating;             // true while refine() only updates the region around the changes
+    float _updbox[4];           // box of the faces changed since the last refinement, during updates
+    float _maxedge;             // bound on the longest edge of the faces not touching the border
+    GsArray<SeDcdtFace*> _updfaces;   // faces near the changes, see _collect_region()
+    GsArray<SeDcdtVertex*> _updverts; // vertices inserted by the refinement during updates
+    GsArray<SeDcdtFace*> _reffaces;   // faces near the vertices inserted by a refinement iteration
+    int _refthreads;            // threads of the passes testing all edges or faces, 0 for all cores
+
+    struct BiSearch { PathTree* tree;          // search tree of the inactive direction
+                      GsArray<float> lmgoal;   // landmark bounds of the inactive direction
+                      SeFace* fg;              // triangle containing the point of the inactive direction
+                      bool backward;           // true while the state of the backward search is active
+                      int stamp, pstamp;       // current search and channel test
+                      GsArray<int> visited;    // faces traversed by the backward search, per face id
+                      GsArray<int> onpath;     // faces of the channel being tested, per face id
+                      struct Cross { int stamp[2], node[2]; };
+                      GsArray<Cross> crossed;  // cheapest forward and backward node crossing each directed edge
+                    };
+    BiSearch* _bi;              // backward search data, allocated by the first bidirectional search
+    bool _bidir;                // single-goal searches are bidirectional
+    int _expanded[2];           // nodes expanded by the last search, forward and backward
+
     struct ExtCl { char l; float r; };
     GsArray<ExtCl> _extcl;
 
@@ -51,6 +148,7 @@ class SeLct : public SeDcdt
     void* _sudata;
     void (*_searchcb) ( void* udata );
     void _construct ();
+    friend class SeLctQuery;
 
    public :
 
@@ -69,10 +167,42 @@ class SeLct : public SeDcdt
         with make_funnel_path(). Note that the channel may not be the globally shortest one. */
     bool search_channel ( float x1, float y1, float x2, float y2, float radius, const SeFace* iniface=0 );
 
+    /*! One-to-many version of search_channel(): a single uniform-cost expansion starting
+        at x1,y1 is performed until the triangles of all goals are settled, and the length of
+        the funnel path of the given radius to each goal is stored in lens (-1 if no path exists),
+        as computed by funnel_path_length(). If paths is not null it must point to goals.size()
+        polygons, which receive the paths; otherwise no path polygon is built.
+        Returns the number of goals reached. As the expansion is not directed to a single goal,
+        the channels found may differ from the ones of independent search_channel() queries.
+        Channels never traverse a triangle twice; goals that may only have been missed because
+        of this restriction are solved with search_channel(). A goal is settled when no leaf of
+        the expansion can lead to a shorter path, so the lengths are not longer than the ones of
+        search_channel(); in debug mode this is verified and violations are reported to gsout. */
+    int search_channels ( float x1, float y1, const GsArray<GsPnt2>& goals, float radius, float dang,
+                          GsArray<float>& lens, GsPolygon* paths=0, const SeFace* iniface=0 );
+
+    /*! Multi-radius version of search_channel(), for vehicles of different sizes going from
+        x1,y1 to x2,y2. The radii are searched in increasing order starting at the triangle of
+        x1,y1, which is located only once. The channel found for the smallest radius is reused for
+        each larger radius passing its clearance, departure and arrival tests, otherwise a new
+        search is made; a reused channel may thus be longer than the one a search would find.
+        A radius without path means that no larger radius has one, and these are not searched.
+        The lengths are stored in lens, in the order of radii (-1 if no path exists), and the
+        paths in paths, if not null, as in search_channels().
+        Returns the number of radii with a path. */
+    int search_radii ( float x1, float y1, float x2, float y2, const GsArray<float>& radii, float dang,
+                       GsArray<float>& lens, GsPolygon* paths=0, const SeFace* iniface=0 );
+
     /*! Use the funnel algorithm to get the shortest path of given clearance radius in the channel
         found by search_channel(). Parameter extclear is in development, leave it zero. */
     void make_funnel_path ( GsPolygon& path, float radius, float dang, float extclear=0 );
 
+    /*! Returns the exact length of the path make_funnel_path() would build for the channel
+        found by search_channel(), summing its tangent segments and circular arcs directly
+        from the funnel corners, without discretizing the arcs or building a polygon.
+        Returns -1 if no path was found. */
+    float funnel_path_length ( float radius, float extclear=0 );
+
     /*! This is the global refinement method which will enforce the local clearance property.
         If parameter force is true, refinements will be checked independently of the internal
         up-to-date flag. The number of refinements performed is returned.
@@ -82,6 +212,78 @@ class SeLct : public SeDcdt
         the triangulation, to ensure that the refined LCT triangulation is shown. */
     int refine ( bool force=false );
 
+    /*! Saves a binary snapshot of the refined triangulation: the mesh connectivity,
+        coordinates, constraint ids, precomputed clearances and inserted polygons.
+        The triangulation is refined first if needed. Returns false if the file
+        could not be written. */
+    bool save_snapshot ( const char* filename );
+
+    /*! Replaces the current triangulation by a snapshot saved with save_snapshot().
+        The file is memory-mapped and copied to the mesh elements without any parsing,
+        refinement or clearance computation. Returns false if the file is not a valid
+        snapshot. */
+    bool load_snapshot ( const char* filename );
+
+    /*! Precomputes the shortest distances without clearance from nlandmarks landmark vertices,
+        chosen by farthest-point selection, to all vertices of the largest free region of the
+        triangulation. Single-goal searches then tighten the A* heuristic with the triangle
+        inequality on the distances of the few landmarks bounding best their start distance to
+        the goal. The distances never exceed the path lengths of any radius, so the heuristic
+        stays admissible. Searches with a radius not smaller than the given one
+        also discard the edges from which the goal triangle cannot be reached with that radius;
+        with radius 0 only the regions without path are discarded. Landmarks are discarded when
+        the triangulation changes. Returns the number of landmarks found. */
+    int compute_landmarks ( int nlandmarks, float radius );
+
+    /*! Discards the landmarks computed with compute_landmarks() */
+    void clear_landmarks ();
+
+    /*! Returns the number of landmarks in use (0 if none) */
+    int landmarks () const { return _lm? _lm->n:0; }
+
+    /*! Builds the junction graph of the triangulation: junction triangles (the ones with three
+        unconstrained edges) are linked by corridors, the chains of triangles between them, which
+        store their minimum clearance and length. Single-goal searches then first find a route in
+        this graph and expand only the triangles of the route, falling back to the full search if
+        no channel is found in the route. The graph is discarded when the triangulation changes.
+        Returns the number of junctions. */
+    int compute_junction_graph ();
+
+    /*! Discards the graph built by compute_junction_graph() */
+    void clear_junction_graph ();
+
+    /*! Returns true if a junction graph is in use */
+    bool junction_graph () const { return _jg? true:false; }
+
+    /*! Builds a compact read-only copy of the refined triangulation in flat arrays: vertex
+        coordinates, and per triangle half-edge the vertex index, the opposite half-edge, the
+        precomputed clearance and a constrained flag, where the next half-edge of a triangle
+        is given by the index. Single-goal searches then expand the triangles over these
+        arrays instead of following the symedge pointers, finding the same channels. Only the
+        channel search uses the copy: the departure and arrival analyses and the funnel still
+        run on the mesh, which must be kept, so the copy adds about 80 bytes per triangle to
+        the memory used by the LCT. It is only used with precomputed clearances, and discarded
+        when the triangulation changes. Returns the number of triangles. */
+    int compute_frozen_mesh ();
+
+    /*! Discards the copy built by compute_frozen_mesh() */
+    void clear_frozen_mesh ();
+
+    /*! Returns true if a frozen copy of the mesh is in use */
+    bool frozen_mesh () const { return _frz? true:false; }
+
+    enum SearchMode { ForwardSearch, BidirectionalSearch };
+
+    /*! Selects how search_channel() expands the triangles. ForwardSearch (the default) is the A*
+        search from x1,y1. BidirectionalSearch also expands an A* search from x2,y2 with the same
+        clearance tests mirrored, always advancing the direction with the smaller front, and stops
+        when a channel joining both trees is not costlier than the lowest cost of the fronts.
+        The channel is then validated with the departure and arrival analyses and the same funnel
+        path is extracted; local queries, and the rare channels rejected there, use the forward
+        search. Multi-goal searches are always forward. */
+    void search_mode ( SearchMode m ) { _bidir = m==BidirectionalSearch; }
+    SearchMode search_mode () const { return _bidir? BidirectionalSearch:ForwardSearch; }
+
    public : // the methods below this point are for expert users only
 
     void auto_refinement ( bool b ) { _auto_refinement=b; }
@@ -89,12 +291,31 @@ class SeLct : public SeDcdt
     void pre_clearance ( bool b ) { _pre_clearance=b; }
     bool pre_clearance ( bool b ) const { return _pre_clearance; }
 
+    /*! When true (the default), refine() compares the faces with the ones of the previous
+        refinement and only re-checks refinements and recomputes clearances for the faces
+        near the changed ones, so that inserting or removing a polygon costs in proportion
+        to the affected neighbourhood. The first refinement is always complete. */
+    void incremental_refinement ( bool b ) { _incremental=b; }
+    bool incremental_refinement () const { return _incremental; }
+
+    /*! Sets the number of threads of the refinement scans testing all edges and of the
+        clearance computation of all triangles, 0 using one thread per core (the default is 1).
+        These passes only read the mesh, each thread testing a contiguous part of the element
+        lists (the edge tests with their own SeLctQuery context), and the results are gathered
+        in list order, so the refinement is the same with any number of threads. The subdivisions, which follow
+        the refinements since only the first and last iterations scan all edges, always run in
+        the calling thread. Meshes too small to benefit use fewer threads. */
+    void refinement_threads ( int n ) { _refthreads=n; }
+    int refinement_threads () const { return _refthreads; }
+
     enum RefinementType { LocalClearanceRef, LocalClearanceMidRef, CorridorRef, JunctionRef };
 
     /*! This refinement method subdivides all non-trivially passages according to the refinement type.
         If parameter maxiter is -1, iterations will not be limited and the refinement will
-        stop only when all refinements are completed (usually only few O(n) iterations are needed).
-        Returns the number of refinements performed. */
+        stop only when all refinements are completed. Each iteration subdivides the passages
+        found by the previous one, and after the first iteration only the triangles near the
+        inserted vertices are tested, with a final test of all edges confirming the end, so
+        that only two O(n) passes are needed. Returns the number of refinements performed. */
     int refine ( RefinementType type, int maxiter=-1, int* niter=0 );
 
     /*! Will precompute maximum clearances per triangle instead of computing them during path search. */
@@ -124,6 +345,7 @@ class SeLct : public SeDcdt
     void get_search_metric ( GsArray<GsPnt2>& pnts );
     void get_search_front ( GsArray<SeBase*>& e );
     int  get_max_fronts () const { return _maxfronts; }
+    int  get_expanded_nodes ( bool backward=false ) const { return _expanded[backward?1:0]; }
     void get_extcl ( int i, char& l, float& r ) const { l=_extcl[i].l; r=_extcl[i].r; }
 
    protected : // internal methods:
@@ -136,6 +358,66 @@ class SeLct : public SeDcdt
     int  _expand_lowest_cost_leaf ();
     void _ptreeaddent ( SeDcdtSymEdge* s, bool top, bool edge );
     bool _search_channel ( double x1, double y1, double x2, double y2, float radius, const SeFace* iniface );
+    bool _reuse_channel ( float radius );
+    // search over the frozen mesh:
+    int  _frzhalfedge ( SeBase* s ) const;
+    void _frzbegin ();
+    void _frztrytoadd ( int en, int ex, int mi, const GsPnt2& p1, const GsPnt2& p2, const GsPnt2& p3 );
+    int  _frz_expand_lowest_cost_leaf ();
+    bool _visited ( SeFace* f ) { return _bi && _bi->backward? _bi->visited[f->id()]==_bi->stamp : _marked(f); }
+    void _visit ( SeFace* f ) { if ( _bi && _bi->backward ) _bi->visited[f->id()]=_bi->stamp; else _mark(f); }
+    int& _crossing ( SeDcdtEdge* e ) { return _marker? _goals.ids[e->id()] : e->nodeid; }
+    bool _crossed ( SeBase* s );
+    void _cross ( SeBase* s );
+    bool _onchannel ( int mi, SeFace* f );
+    void _addbound ( int ni );
+    float _goalbound ();
+    void _reach_goals ( int mi, SeDcdtSymEdge* s );
+    bool _finish_goals ( float cost );
+    void _search_channels ( double x1, double y1, float radius, const SeFace* iniface );
+    // bidirectional search:
+    void _biswap ();
+    bool _bichannel ( int f, int b, bool build );
+    bool _bichannelends ();
+    void _bimeet ( int i, float& best, int& bf, int& bb );
+    int  _bisearch_channel ( double x1, double y1, double x2, double y2, float radius, const SeFace* iniface );
+    // landmark heuristic:
+    int _lmcomponent ( int i, int c, float d2, const GsArray<SeDcdtEdge*>& edges, GsArray<int>& comp );
+    void _lmgeodesic ( int l, const GsArray<SeDcdtVertex*>& verts, const GsArray<char>& corner, GsArray<float>& d );
+    bool _lmfree ( SeBase* s );
+    int _lmslot ( SeBase* s );
+    void _lmbounds ( SeBase* s, double x, double y, float* b );
+    void _lmsetgoal ( SeBase* s, double xs, double ys, double x, double y, float radius );
+    float _heuristic ( SeBase* s, double x, double y );
+    // junction graph:
+    void _jgcorridor ( int j, int k );
+    void _jgpush ( int st, float gc, int parent, int corr, const GsPnt2& p, const GsPnt2& goal );
+    void _jgallowcorridor ( int ci );
+    int  _jgroute ( const SeFace* iniface, double x1, double y1, double x2, double y2, float radius );
+    // point location:
+    void _build_locgrid ();
+    const SeFace* _locseed ( double x, double y );
+    // incremental updates:
+    void _facesig ( SeDcdtFace* f, FaceSig& sig );
+    void _save_facesigs ();
+    bool _changed ( SeDcdtFace* f );
+    void _grow_changes ( SeDcdtFace* f, const float* box, int& n );
+    bool _find_changes ();
+    void _find_new_changes ();
+    void _collect_region ();
+    bool _depends ( SeDcdtFace* f );
+    void _collect_refinements ( RefinementType type );
+    void _refine_neighbours ( SeDcdtVertex* v );
+    void _collect_neighbour_refinements ( RefinementType type );
+    // parallel passes:
+    int  _passthreads ( int n ) const;
+    void _collect_all_refinements ( RefinementType type );
+    void _scan_refinements ( SeDcdtEdge* const* edges, int n, RefinementType type, GsArray<SeDcdtSymEdge*>* out );
+    void _clear_faces ( SeDcdtFace* const* faces, int n );
+    void _face_clearance ( SeDcdtFace* f );
+    void _finish_update ();
+    void _update_locgrid ();
+    void _compact_ids ();
     // sector tests:
     bool _local_transition_free ( SeDcdtSymEdge* e, SeDcdtSymEdge* s, double d2, double px, double py );
     double _sector_clearance ( SeDcdtSymEdge* s, double maxr2, const GsVec2& c, const GsVec2& p1, const GsVec2& p2 );
@@ -158,6 +440,9 @@ class SeLct : public SeDcdt
     void _funnelclose ( FunnelDeque* funnel, FunnelPath* fpath, int ei, float radius );
     void _fpathpush ( FunnelPath* fpath, const FunnelPt& fp3, float radius );
     void _fpathmake ( FunnelPath* fpath, GsPolygon& path, float radius, float dang );
+    float _fpathlen ( FunnelPath* fpath );
+    float _flocallen ( float radius );
+    void _funnelrun ( float radius, float extclear );
     void _finitextcl ( float radius, float extclear );
     float _fgetextr ( int c, char m, float radius, float extclear );
  };
@@ -0,0 +1,58 @@
+/*=======================================================================
+   Copyright 2010 Marcelo Kallmann. All Rights Reserved.
+   This software is distributed for noncommercial use only, without
+   any warranties, and provided that all copies contain the full copyright
+   notice licence.txt located at the base folder of the distribution. 
+  =======================================================================*/
+
+# ifndef SE_LCT_BATCH_H
+# define SE_LCT_BATCH_H
+
+/** \file se_lct_batch.h
+ * Parallel execution of path queries over one LCT
+ */
+
+# include <gsim/se_lct_query.h>
+
+//================================== SeLctBatch class ========================================
+
+/*! SeLctBatch solves many path queries over one LCT using a pool of worker threads.
+    Each worker has its own SeLctQuery context over the shared mesh. The queries of a
+    batch are split in one contiguous range per worker, and workers which finish their
+    range steal the second half of the range of another worker, so that the load is
+    balanced even when query costs vary a lot. Results are always stored in input order. */
+class SeLctBatch
+ { public :
+    /*! A path query from x1,y1 to x2,y2 with the given clearance radius */
+    struct Query { float x1, y1, x2, y2, radius;
+                   void set ( float a, float b, float c, float d, float r ) { x1=a; y1=b; x2=c; y2=d; radius=r; }
+                 };
+
+   private :
+    struct Pool;
+    Pool* _pool;
+
+   public :
+
+    /*! Creates nthreads workers over the mesh of the given LCT, or one worker per
+        hardware thread if nthreads<=0. The LCT is refined here, and it must not be
+        modified while the batch object exists. */
+    SeLctBatch ( SeLct* lct, int nthreads=0 );
+
+    /*! Stops and joins all workers */
+    ~SeLctBatch ();
+
+    /*! Returns the number of workers */
+    int threads () const;
+
+    /*! Solves all given queries in parallel and stores in lens the length of the
+        path of each query, as given by SeLct::funnel_path_length(), or -1 if no path exists.
+        If paths is not null it must point to queries.size() polygons, which receive the
+        paths; otherwise no path polygon is built. The call returns when all
+        queries are solved, and the number of paths found is returned. */
+    int run ( const GsArray<Query>& queries, GsArray<float>& lens, GsPolygon* paths=0, float dang=GS_TORAD(10.0f) );
+ };
+
+//================================== End of File =========================================
+
+# endif // SE_LCT_BATCH_H
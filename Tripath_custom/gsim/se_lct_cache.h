@@ -0,0 +1,105 @@
+/*=======================================================================
+   Copyright 2010 Marcelo Kallmann. All Rights Reserved.
+   This software is distributed for noncommercial use only, without
+   any warranties, and provided that all copies contain the full copyright
+   notice licence.txt located at the base folder of the distribution.
+  =======================================================================*/
+
+# ifndef SE_LCT_CACHE_H
+# define SE_LCT_CACHE_H
+
+/** \file se_lct_cache.h
+ * Cache of path query results
+ */
+
+# include <gsim/se_lct_batch.h>
+
+//================================== SeLctCache class ========================================
+
+/*! SeLctCache stores the results of path queries so that repeated queries are answered
+    without searching. Entries are keyed by the query endpoints quantized to a grid of the
+    given quantum, the radius, and a group number used to keep apart results computed by
+    different search methods. At most capacity entries are kept, and the least recently
+    used one is replaced when the cache is full. Each entry stores the path length and
+    optionally the path polygon with the arc sampling angle used to build it.
+    The mesh version given to get() and put() (see SeDcdt::version()) is compared to the
+    version of the stored entries, and all entries are discarded when it changes, unless
+    the change was reported with update(), which only discards the affected entries. */
+class SeLctCache
+ { private :
+    struct Entry { int k[4];      // quantized endpoints
+                   float radius;
+                   int group;
+                   float len;     // path length, -1 if there is no path
+                   float dang;    // arc sampling angle of path, 0 if no path polygon is stored
+                   GsPolygon path;
+                   int hnext;     // next entry in the hash bucket, or in the free list
+                   int prev, next; // recency list
+                 };
+    Entry* _entries;
+    GsArray<int> _buckets;
+    int _capacity, _size, _free;
+    int _first, _last;           // most and least recently used entries
+    int _version;
+    float _quantum;
+    int _hits, _misses;
+    void _key ( const SeLctBatch::Query& q, int* k ) const;
+    int _bucket ( const int* k, float radius, int group ) const;
+    int _find ( const int* k, float radius, int group, int& b ) const;
+    void _unlink ( int e );
+    void _pushfront ( int e );
+    void _check ( int version );
+    void _drop ( int e );
+    bool _affected ( const Entry& en, const float* box, bool removal ) const;
+
+   public :
+
+    /*! Creates a cache for up to capacity entries, with endpoints quantized to quantum */
+    SeLctCache ( int capacity=4096, float quantum=0.001f );
+
+    /*! Destructor */
+   ~SeLctCache ();
+
+    /*! Discards all entries and changes the capacity; a zero capacity disables the cache */
+    void capacity ( int c );
+    int capacity () const { return _capacity; }
+
+    /*! Discards all entries and changes the quantization step of the endpoints */
+    void quantum ( float q );
+    float quantum () const { return _quantum; }
+
+    /*! Returns the number of stored entries */
+    int size () const { return _size; }
+
+    /*! Returns the number of successful and unsuccessful lookups since the cache was created */
+    int hits () const { return _hits; }
+    int misses () const { return _misses; }
+
+    /*! Discards all entries */
+    void clear ();
+
+    /*! Reports that the polygon pol was inserted in the mesh, or removed if removal is true,
+        changing it to the given version, e.g. a no-fly zone appearing or moving. A path of
+        length l between p1 and p2 lies in the ellipse of points p with |p-p1|+|p-p2|<=l, so
+        an insertion keeps the entries whose ellipse, grown by the radius, is away from the
+        bounding box of pol, and a removal keeps the entries whose paths are shorter than any
+        path passing by the freed region. Entries without path are only kept by insertions.
+        All entries are discarded if the cache was not at the previous version. This is a
+        result cache only: the queries of discarded entries are searched again from scratch,
+        at the cost of a full search over the map, as no search tree is kept or repaired. */
+    void update ( int version, const GsPolygon& pol, bool removal );
+
+    /*! Looks for the result of query q computed over the given mesh version. If found, its
+        length is stored in len and true is returned. If path is not null the entry must also
+        store a path polygon sampled with dang, which is then copied to path. */
+    bool get ( int version, const SeLctBatch::Query& q, float& len, GsPolygon* path=0, float dang=0, int group=0 );
+
+    /*! Stores the result of query q computed over the given mesh version, replacing the
+        least recently used entry if the cache is full. If path is not null the polygon is
+        also stored, as sampled with dang. */
+    void put ( int version, const SeLctBatch::Query& q, float len, const GsPolygon* path=0, float dang=0, int group=0 );
+ };
+
+//================================== End of File =========================================
+
+# endif // SE_LCT_CACHE_H
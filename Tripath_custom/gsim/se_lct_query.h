@@ -0,0 +1,51 @@
+/*=======================================================================
+   Copyright 2010 Marcelo Kallmann. All Rights Reserved.
+   This software is distributed for noncommercial use only, without
+   any warranties, and provided that all copies contain the full copyright
+   notice licence.txt located at the base folder of the distribution. 
+  =======================================================================*/
+
+# ifndef SE_LCT_QUERY_H
+# define SE_LCT_QUERY_H
+
+/** \file se_lct_query.h
+ * Concurrent path queries over a shared LCT
+ */
+
+# include <gsim/se_lct.h>
+
+//================================== SeLctQuery class ========================================
+
+/*! SeLctQuery is a query context sharing the mesh of a given SeLct. Each context
+    has its own path tree, heap, funnel buffers and element marks (kept in a
+    SeMeshMarker indexed by element ids), so that several threads can call
+    search_channel(), search_channels() and make_funnel_path() at the same time,
+    each one with its own context, as long as the mesh is not modified.
+    The source SeLct is refined when the context is created, and it must not be
+    changed while contexts are in use: a context only reads the shared mesh and
+    therefore becomes invalid after any insertion or removal in the source, and
+    should then be created again. Methods modifying the mesh must not be called
+    on contexts. The landmarks, junction graph, frozen mesh and point location grid
+    of the source are referenced by the context, which keeps using them when the
+    source discards or replaces them; contexts must then be created again to use
+    the new ones. As the reference counters are not atomic, contexts must be
+    created and deleted by the thread owning the source. */
+class SeLctQuery : public SeLct
+ { protected :
+    SeMeshMarker _qmarker;
+
+   public :
+
+    /*! Creates a query context for the given LCT, which is refined here if needed.
+        This constructor modifies the source and must not run concurrently with queries.
+        If refine is false the source is shared as it is, as done by the parallel
+        refinement passes of SeLct, which only call the tests of the contexts. */
+    SeLctQuery ( SeLct* lct, bool refine=true );
+
+    /*! Destructor, the shared mesh is only unreferenced */
+    virtual ~SeLctQuery ();
+ };
+
+//================================== End of File =========================================
+
+# endif // SE_LCT_QUERY_H
@@ -43,7 +43,7 @@
 \endcode */
 
 # include <gsim/gs_array.h>
-# include <gsim/gs_manager.h>
+# include <gsim/gs_pool.h>
 # include <gsim/se_elements.h>
 
 // ====================================== SeMeshBase ======================================
@@ -90,9 +90,11 @@ class SeMeshBase : public GsShared
     gscbool _op_last_msg;           // Keeps the last result of an operator (OpMsg type)
     gscbool _output_op_errors;      // Flag that outputs all errors ocurred during operators (default true)
     int _vertices, _edges, _faces; // Elem counters
+    int _nextid;                   // Id to be given to the next allocated element
     semeshindex _curmark;          // Current values for marking
     gscbool _marking, _indexing;    // flags to indicate that marking or indexing is on
     GsManagerBase *_vtxman, *_edgman, *_facman; // keep used managers
+    GsPool<SeBase> _sepool;        // symedges are allocated in slabs and released at once by destroy()
  
   private : // Private methods ==========================================================================
     void _defaults ();
@@ -135,6 +137,16 @@ class SeMeshBase : public GsShared
     /*! Returns the number of faces in the mesh. */
     int faces () const { return _faces; }
 
+    /*! Returns a value greater than the id of any element in the mesh. Ids are given
+        in allocation order and are never reused, until the mesh is destroyed or
+        compact_ids() is called. */
+    int idbound () const { return _nextid; }
+
+    /*! Renumbers all elements with consecutive ids, vertices first, then edges and faces,
+        so that idbound() becomes the number of elements again. Data indexed by the old
+        ids is no longer valid. Returns the new idbound(). */
+    int compact_ids ();
+
     /*! Invert orientation of all faces. */
     void invert_faces ();
 
@@ -299,6 +311,21 @@ class SeMeshBase : public GsShared
         virtual methods input() of the associated element managers.
         Note: indexing is used during load().  */
     bool load ( GsInput& inp );
+
+    /*! Puts in S, V, E and F all symedges and elements of the mesh, and in T the
+        connectivity of the mesh as indices to these arrays: five indices per symedge
+        (nxt, rot, vertex, edge and face), followed by the index of the symedge referenced
+        by each vertex, edge and face, and by the index of the first symedge.
+        The symedges of edge i are S[2i] and S[2i+1]. Note: indexing is used here. */
+    void get_topology ( GsArray<SeBase*>& S, GsArray<SeElement*>& V, GsArray<SeElement*>& E,
+                        GsArray<SeElement*>& F, GsArray<int>& T );
+
+    /*! Destroys the mesh and creates a new one from connectivity T, given in the format of
+        get_topology(). Elements are allocated with the mesh managers and returned in V, E
+        and F, so that the caller can set their data. False is returned (and the mesh
+        is left empty) if T has an index out of range. */
+    bool set_topology ( int ns, int nv, int ne, int nf, const int* T,
+                        GsArray<SeElement*>& V, GsArray<SeElement*>& E, GsArray<SeElement*>& F );
  };
 
 /*! This is the template version of the SeMeshBase class, that redefines
@@ -306,7 +333,8 @@ class SeMeshBase : public GsShared
     type casts to the user-defined classes. All methods are implemented
     inline just calling the corresponding method of the base class but 
     correctly applying type casts to convert default (base) types to
-    the correct user types. */
+    the correct user types. The default constructor allocates the elements
+    with GsPoolManager, in slabs which destroy() releases at once. */
 template <class V, class E, class F> //, class VM, class EM, class FM>
 class SeMesh : public SeMeshBase
  { public :
@@ -315,7 +343,7 @@ class SeMesh : public SeMeshBase
     typedef GsManager<E> EM;
     typedef GsManager<F> FM;
 
-    SeMesh () : SeMeshBase ( new VM, new EM, new FM ) {}
+    SeMesh () : SeMeshBase ( new GsPoolManager<V>, new GsPoolManager<E>, new GsPoolManager<F> ) {}
     SeMesh ( VM* vm, EM* em, FM* fm ) : SeMeshBase ( vm, em, fm ) {}
 
     S* first () const { return (S*)SeMeshBase::first(); }
@@ -335,6 +363,35 @@ class SeMesh : public SeMeshBase
     S* delv ( S* y )           { return (S*)SeMeshBase::delv(y); }
  };
 
+/*! SeMeshMarker keeps element marks outside of the mesh, indexed by the element ids.
+    It allows several marking sessions to run at the same time over one mesh, for
+    instance in concurrent queries over a mesh which is not being modified.
+    The marking rules are the same as the ones of SeMeshBase::begin_marking(). */
+class SeMeshMarker
+ { private :
+    GsArray<semeshindex> _marks; // one mark per element id, shrunk when the ids are compacted
+    semeshindex _curmark;
+
+   public :
+    SeMeshMarker () { _curmark=0; }
+
+    /*! Starts a marking session for elements of the given mesh, which must
+        not be modified until end_marking() is called. */
+    void begin_marking ( const SeMeshBase* m );
+
+    /*! Finishes the marking session, only for symmetry with SeMeshBase */
+    void end_marking () {}
+
+    /*! See if an element is marked (begin_marking() should be called first) */
+    bool marked ( const SeElement* e ) const { return _marks[e->id()]==_curmark; }
+
+    /*! Mark an element (begin_marking() should be called first) */
+    void mark ( const SeElement* e ) { _marks[e->id()]=_curmark; }
+
+    /*! Unmark an element (begin_marking() should be called first) */
+    void unmark ( const SeElement* e ) { _marks[e->id()]=_curmark-1; }
+ };
+
 /*! \class SeMeshBase se_mesh.h
     \brief manages topology and attached information of a symedge mesh.
 
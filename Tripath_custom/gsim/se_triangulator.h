@@ -71,6 +71,13 @@ class SeTriangulator : public GsShared
     FunnelDeque* _fdeque;
     bool _path_found;
     bool _debug_mode;
+    bool _dcdtman;                   // true when _man is a SeDcdtManager, see SeDcdt
+    SeMeshMarker* _marker;           // if not null, queries mark elements here instead of in the mesh
+    void _begin_marking () { if (_marker) _marker->begin_marking(_mesh); else _mesh->begin_marking(); }
+    void _end_marking () { if (_marker) _marker->end_marking(); else _mesh->end_marking(); }
+    bool _marked ( SeElement* e ) { return _marker? _marker->marked(e) : _mesh->marked(e); }
+    void _mark ( SeElement* e ) { if (_marker) _marker->mark(e); else _mesh->mark(e); }
+    void _unmark ( SeElement* e ) { if (_marker) _marker->unmark(e); else _mesh->unmark(e); }
 
    public :
 
@@ -311,12 +318,19 @@ class SeTriangulator : public GsShared
     int refine_edges ( float targetlen, bool markvref=true );
 
    protected :
-    void _propagate_delaunay ();
+    // The point location, insertion and line constraint methods are instantiated with the class
+    // of the manager: SeTriangulatorManager in general, and SeDcdtManager when _dcdtman is set,
+    // so that the coordinates and constraints of SeDcdt elements are accessed inline.
+    template <class M> LocateResult _locate_point ( const SeFace* iniface, double x, double y, SeBase*& result, bool loctest );
+    template <class M> SeVertex* _insert_point_in_face ( SeFace* f, double x, double y );
+    template <class M> SeVertex* _insert_point_in_edge ( SeEdge* e, double x, double y );
+    template <class M> void _propagate_delaunay ();
+    template <class M> bool _constrain_line ( SeVertex*, SeVertex*, const GsArray<int>& );
+    template <class M> void _v_next_step ( SeBase* s, SeVertex* v1, SeVertex* v2, SeVertex*& v, SeBase*& e );
+    template <class M> void _e_next_step ( SeBase* s, SeVertex* v1, SeVertex* v2, SeVertex*& v, SeBase*& e );
+    template <class M> bool _canconnect ( SeBase* s2, SeBase* sv, double x2, double y2, double x2n, double y2n );
+    template <class M> int _refine_edges ( float targetlen, bool markvref );
     bool _conform_line  ( SeVertex*, SeVertex*, const GsArray<int>& );
-    bool _constrain_line ( SeVertex*, SeVertex*, const GsArray<int>& );
-    void _v_next_step ( SeBase* s, SeVertex* v1, SeVertex* v2, SeVertex*& v, SeBase*& e );
-    void _e_next_step ( SeBase* s, SeVertex* v1, SeVertex* v2, SeVertex*& v, SeBase*& e );
-    bool _canconnect ( SeBase* s2, SeBase* sv, double x2, double y2, double x2n, double y2n );
     void _maketri ( GsArray<SeBase*>& totrig, SeBase* s2, SeBase* s1, SeBase* s );
     void _getcostpoint ( PathNode* n, double xn, double yn, double x1, double y1, double x2, double y2, double& x, double& y, double r=0 );
     void _trytoadd ( SeBase* s, int mi, PathNode* n=0, double x1=0, double y1=0, double x2=0, double y2=0 );
@@ -31,6 +31,19 @@ void SeDcdt::_construct ()
    _using_domain = false; // only used internally in some operations
    _xmin = _xmax = _ymin = _ymax = 0;
    _dcdt_changed = true;
+   _version = 0;
+   _editall = true;
+   _dcdtman = true; // the triangulator methods are instantiated with SeDcdtManager
+ }
+
+// starts a new edit box at p, or extends the last one; too many boxes mean everything changed
+void SeDcdt::_add_edit ( const GsPnt2& p, bool first )
+ {
+   if ( first && _edits.size()>=4096 ) { _edits.size(0); _editall=true; }
+   if ( first ) { _edits.push()=p.x; _edits.push()=p.y; _edits.push()=p.x; _edits.push()=p.y; return; }
+   float* b = &_edits[_edits.size()-4];
+   if ( p.x<b[0] ) b[0]=p.x; else if ( p.x>b[2] ) b[2]=p.x;
+   if ( p.y<b[1] ) b[1]=p.y; else if ( p.y>b[3] ) b[3]=p.y;
  }
 
 SeDcdt::SeDcdt ( double epsilon )
@@ -194,7 +207,7 @@ static void _read_pol ( GsInput& inp, GsPolygon& pol, float maxlen )
    if ( maxlen>0 ) pol.resample ( maxlen );
  }
 
-bool SeDcdt::load ( GsInput& inp )
+bool SeDcdt::load ( GsInput& inp, int variant )
  {
    GsPolygon pol;
    pol.capacity ( 64 );
@@ -207,6 +220,7 @@ bool SeDcdt::load ( GsInput& inp )
    float inflatedang = 0;
    int simplify = 0; // false
    int id, nextid=1;
+   int curvariant=variant; // polygons before any variant keyword are always loaded
 
    // signature:
    inp.commentchar ( '#' );
@@ -244,10 +258,12 @@ bool SeDcdt::load ( GsInput& inp )
          init ( pol, epsilon, radius );
          if ( epsedg>0 ) epsilonedg(epsedg);
        }
+      else if ( s=="variant" )
+       { inp >> curvariant;
+       }
       else if ( s=="polygon" )
        { if ( num_polygons()==0 ) return false;
          inp >> id;
-         while ( id>nextid ) { _polygons.insert(0); nextid++; }
          inp.get();
          if ( inp.ltoken()=="open" )
           { pol.open(true); }
@@ -256,6 +272,8 @@ bool SeDcdt::load ( GsInput& inp )
             pol.open(false);
           }
          _read_pol ( inp, pol, maxlen );
+         if ( curvariant!=variant ) continue; // polygon of another variant
+         while ( id>nextid ) { _polygons.insert(0); nextid++; }
 
          if ( simplify )
           { GsPolygon p(pol);
@@ -287,6 +305,9 @@ void SeDcdt::init ( const GsPolygon& domain , double epsilon, float radius )
    _cur_search_face = 0;
 
    _dcdt_changed = true;
+   _version++;
+   _edits.size ( 0 );
+   _editall = true;
 
    // Clear structures if needed:
    if ( _backface ) 
@@ -358,6 +379,8 @@ int SeDcdt::insert_polygon ( const GsPolygon& pol )
    SeFace* sface;
 
    _dcdt_changed = true;
+   _version++;
+   for ( i=0; i<pol.size(); i++ ) _add_edit ( pol[i], i==0 );
 
    GS_TRACE1 ( "Inserting entry in the polygon set..." ); // put in _polygons
    id = _polygons.insert();
@@ -528,6 +551,7 @@ void SeDcdt::remove_polygon ( int polygonid )
    GS_TRACE4 ( "Entering remove_polygon..." );
 
    _dcdt_changed = true;
+   _version++;
 
    if ( polygonid==0 )
      gsout.fatal("se_dcdt.cpp: domain cannot be removed by remove_polygon().");
@@ -545,6 +569,7 @@ void SeDcdt::remove_polygon ( int polygonid )
    GS_TRACE4 ( "Recuperating full polygon..." );
    _find_intermediate_vertices_and_edges ( _polygons[polygonid]->get(0), polygonid ); 
    GS_TRACE4 ( "polygon has "<<_varray.size()<<" vertices " << "and "<<_earray.size()<<" edges." ); 
+   for ( i=0; i<_varray.size(); i++ ) _add_edit ( _varray[i]->p, i==0 );
 
    // Remove all ids which are equal to polygonid in the edge constraints
    GS_TRACE4 ( "Updating edge constraints..." );
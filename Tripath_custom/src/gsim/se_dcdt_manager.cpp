@@ -12,33 +12,6 @@
 
 //============================== SeDcdtManager ==================================
 
-void SeDcdtManager::get_vertex_coordinates ( const SeVertex* v, double& x, double & y )
- {
-   x = (double) ((SeDcdtVertex*)v)->p.x;
-   y = (double) ((SeDcdtVertex*)v)->p.y;
- }
-
-void SeDcdtManager::set_vertex_coordinates ( SeVertex* v, double x, double y )
- {
-   ((SeDcdtVertex*)v)->p.x = (float) x;
-   ((SeDcdtVertex*)v)->p.y = (float) y;
- }
-
-void SeDcdtManager::new_steiner_vertex_created ( SeVertex* v )
- {
-   ((SeDcdtVertex*)v)->refinement = true;
- }
-
-bool SeDcdtManager::is_constrained ( SeEdge* e )
- {
-   return ((SeDcdtEdge*)e)->is_constrained();
- }
-
-void SeDcdtManager::set_unconstrained ( SeEdge* e )
- {
-   ((SeDcdtEdge*)e)->set_unconstrained();
- }
-
 void SeDcdtManager::get_constraints ( SeEdge* e, GsArray<int>& ids )
  {
    int i;
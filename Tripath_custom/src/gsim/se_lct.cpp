@@ -26,8 +26,26 @@ void SeLct::_construct ()
    _fudata = _sudata = 0;
    _funnelcb = _searchcb = 0;
    _dcdt_changed = true;
+   _goals.lens = 0;
+   _goals.paths = 0;
+   _goals.open = 0;
    _auto_refinement = true;
    _pre_clearance = true;
+   _lm = 0;
+   _jg = 0;
+   _jgstamp = 0;
+   _jgrestrict = false;
+   _frz = 0;
+   _frzstamp = 0;
+   _frzfi = -1;
+   _lg = new LocGrid;
+   _lg->ref ();
+   _incremental = true;
+   _updating = false;
+   _maxedge = 0;
+   _refthreads = 1;
+   _bi = 0;
+   _bidir = false;
    _clear_path ();
  }
 
@@ -47,6 +65,12 @@ SeLct::SeLct ( SeMeshBase* m, SeDcdtManager* man, double epsilon )
 SeLct::~SeLct () 
  {
    delete _fpath;
+   clear_landmarks ();
+   clear_junction_graph ();
+   clear_frozen_mesh ();
+   _lg->unref ();
+   if ( _bi ) delete _bi->tree;
+   delete _bi;
  }
 
 //================================================================================
@@ -64,9 +88,22 @@ bool SeLct::search_channel ( float x1, float y1, float x2, float y2, float radiu
    // check if refinment is needed:
    if ( _dcdt_changed ) refine ();
 
-   // search for channel:
-   if ( !iniface ) iniface = get_search_face();
+   // search for channel, restricted to the triangles of a route in the junction graph if available:
+   if ( !iniface ) iniface = _locseed ( x1, y1 );
+   int route = _jg? _jgroute ( iniface, (double)x1, (double)y1, (double)x2, (double)y2, radius ) : 0;
+   if ( route<0 ) // the junction graph shows that no path exists
+    { _clear_path ();
+      _channel.size(0);
+      if ( _ptree ) _ptree->init ( radius ); // no search nodes
+      return false;
+    }
+   _jgrestrict = route>0;
    bool found = _search_channel ( (double)x1, (double)y1, (double)x2, (double)y2, radius, iniface );
+   if ( !found && _jgrestrict ) // the route was not passable, search again in the whole triangulation
+    { _jgrestrict = false;
+      found = _search_channel ( (double)x1, (double)y1, (double)x2, (double)y2, radius, iniface );
+    }
+   _jgrestrict = false;
 
    // to optimize searching for next queries around the same point,
    // we set the next starting search face to the first channel face:
@@ -76,6 +113,169 @@ bool SeLct::search_channel ( float x1, float y1, float x2, float y2, float radiu
    return found;
  }
 
+int SeLct::search_channels ( float x1, float y1, const GsArray<GsPnt2>& goals, float radius, float dang,
+                             GsArray<float>& lens, GsPolygon* paths, const SeFace* iniface )
+ {
+   int i, n=goals.size();
+   lens.size ( n );
+   lens.setall ( -1.0f );
+   if ( paths ) for ( i=0; i<n; i++ ) paths[i].size(0);
+
+   // same security test as in search_channel():
+   if ( n==0 || x1<_xmin || x1>_xmax ) return 0;
+
+   // check if refinment is needed:
+   if ( _dcdt_changed ) refine ();
+   if ( !iniface ) iniface = _locseed ( x1, y1 );
+
+   _goals.pts = goals;
+   _goals.st.size ( n );
+   _goals.lens = &lens[0];
+   _goals.paths = paths;
+   _goals.dang = dang;
+   _goals.open = 0;
+   _goals.pruned = 0;
+   for ( i=0; i<n; i++ )
+    { if ( goals[i].x<_xmin || goals[i].x>_xmax ) { _goals.st[i]='u'; continue; }
+      _goals.st[i] = radius>0? 'o':'l'; // radius zero paths are left to single queries
+      if ( radius>0 ) _goals.open++;
+    }
+
+   // expand the search once for all goals:
+   if ( _goals.open>0 )
+    { _search_channels ( (double)x1, (double)y1, radius, iniface );
+      if ( _fi ) _cur_search_face = (SeDcdtFace*)_fi;
+    }
+   _goals.pts.size(0); // back to single-goal searches
+
+   // goals in the initial triangle may have trivial or local paths and are solved individually, and
+   // so are the open goals when channels entering a triangle twice were rejected, as they may have been missed:
+   if ( _goals.pruned>0 )
+    { for ( i=0; i<n; i++ ) if ( _goals.st[i]=='o' ) _goals.st[i]='l';
+    }
+
+   int reached=0;
+   for ( i=0; i<n; i++ )
+    { if ( _goals.st[i]=='l' && search_channel(x1,y1,goals[i].x,goals[i].y,radius,iniface) )
+       { lens[i] = funnel_path_length ( radius );
+         if ( paths ) make_funnel_path ( paths[i], radius, dang );
+         _goals.st[i] = 'r';
+       }
+      if ( _goals.st[i]=='r' ) reached++;
+    }
+
+   // in debug mode the lengths are compared with the ones of single-goal searches, which
+   // are not shorter as the expansion settles a goal only when no leaf can lead to a shorter path:
+   if ( _debug_mode )
+    { for ( i=0; i<n; i++ )
+       { float len = search_channel(x1,y1,goals[i].x,goals[i].y,radius,iniface)? funnel_path_length(radius) : -1.0f;
+         if ( (len<0)!=(lens[i]<0) || lens[i]>1.001f*len )
+          gsout<<"search_channels: goal "<<i<<" has length "<<lens[i]<<", search_channel() gives "<<len<<gsnl;
+       }
+    }
+
+   return reached;
+ }
+
+static int fltcmp ( const float* a, const float* b )
+ {
+   return *a<*b? -1 : *a>*b? 1:0;
+ }
+
+int SeLct::search_radii ( float x1, float y1, float x2, float y2, const GsArray<float>& radii, float dang,
+                          GsArray<float>& lens, GsPolygon* paths, const SeFace* iniface )
+ {
+   int i, k, n=radii.size();
+   lens.size ( n );
+   lens.setall ( -1.0f );
+   if ( paths ) for ( i=0; i<n; i++ ) paths[i].size(0);
+   if ( n==0 ) return 0;
+
+   if ( _dcdt_changed ) refine ();
+   if ( !iniface ) iniface = _locseed ( x1, y1 );
+   SeBase* s;
+   if ( locate_point(iniface,x1,y1,s)==NotFound ) return 0;
+   iniface = s->fac();
+
+   // distinct radii in increasing order:
+   GsArray<float> r ( radii );
+   r.sort ( fltcmp );
+   int nr = 0;
+   for ( i=0; i<n; i++ ) if ( nr==0 || r[i]!=r[nr-1] ) r[nr++]=r[i];
+   r.size ( nr );
+
+   // search with the smallest radius, and again only when its channel is blocked for a larger one:
+   GsArray<float> rlens ( nr );
+   GsPolygon* rpaths = paths? new GsPolygon[nr] : 0;
+   rlens.setall ( -1.0f );
+   for ( k=0; k<nr; k++ )
+    { if ( k==0 || !_reuse_channel(r[k]) )
+       { if ( !search_channel(x1,y1,x2,y2,r[k],iniface) ) break; }
+      rlens[k] = funnel_path_length ( r[k] );
+      if ( rpaths ) make_funnel_path ( rpaths[k], r[k], dang );
+    }
+
+   int reached=0;
+   for ( i=0; i<n; i++ )
+    { k = r.bsearch ( radii[i], fltcmp );
+      lens[i] = rlens[k];
+      if ( rpaths ) // GsPolygon has no copy operator, the one of GsArray copies the points
+       { (GsArray<GsPnt2>&)paths[i] = rpaths[k];
+         paths[i].open ( rpaths[k].open() );
+       }
+      if ( lens[i]>=0 ) reached++;
+    }
+   delete[] rpaths;
+   return reached;
+ }
+
+//================================================================================
+//=============================== point location =================================
+//================================================================================
+
+// Uniform grid over the domain with about one cell per two faces. Each cell stores a face
+// containing its center, found with a walk from the face of the previous cell.
+void SeLct::_build_locgrid ()
+ {
+   if ( _lg->getref()>1 ) // the query contexts keep the grid they share
+    { _lg->unref(); _lg=new LocGrid; _lg->ref(); }
+   LocGrid& g = *_lg;
+   float w = _xmax-_xmin;
+   float h = _ymax-_ymin;
+   if ( w<=0 || h<=0 ) { g.cells.size(0); return; }
+
+   int n = _mesh->faces()/2;
+   if ( n<1 ) n=1;
+   g.nx = (int)sqrt ( double(n)*w/h );
+   if ( g.nx<1 ) g.nx=1;
+   g.ny = n/g.nx;
+   if ( g.ny<1 ) g.ny=1;
+   g.x=_xmin; g.y=_ymin;
+   g.cw=w/g.nx; g.ch=h/g.ny;
+   g.cells.size ( g.nx*g.ny );
+
+   SeBase* s;
+   const SeFace* f = get_search_face();
+   for ( int j=0; j<g.ny; j++ )
+    for ( int k=0; k<g.nx; k++ )
+     { int i = j%2? g.nx-1-k : k; // rows alternate direction so that each walk is short
+       if ( locate_point(f,g.x+g.cw*(i+0.5f),g.y+g.ch*(j+0.5f),s,false)!=NotFound ) f=s->fac();
+       g.cells[j*g.nx+i] = (SeDcdtFace*)f;
+     }
+ }
+
+// face near x,y to start point location walks, the current search face if there is no grid
+const SeFace* SeLct::_locseed ( double x, double y )
+ {
+   const LocGrid& g = *_lg;
+   if ( g.cells.empty() ) return get_search_face();
+   int i = int ( (x-g.x)/g.cw );
+   int j = int ( (y-g.y)/g.ch );
+   if ( i<0 ) i=0; else if ( i>=g.nx ) i=g.nx-1;
+   if ( j<0 ) j=0; else if ( j>=g.ny ) j=g.ny-1;
+   return g.cells[j*g.nx+i];
+ }
+
 //================================================================================
 //============================ refinement methods ================================
 //================================================================================
@@ -84,16 +284,33 @@ int SeLct::refine ( bool force )
  {
    if ( !_dcdt_changed && !force ) return 0;
 
+   clear_landmarks (); // distances are no longer valid
+   clear_junction_graph ();
+   clear_frozen_mesh ();
+
+   // after a complete refinement only the neighbourhood of the changed faces is updated:
+   _updating = _incremental && !force && !_editall;
+   if ( _updating && !_find_changes() )
+    { _updating=false; _edits.size(0); _dcdt_changed=false; return 0; }
+
    int nref=0;
    if ( _auto_refinement )
     { 
       nref += refine ( LocalClearanceRef );
     }
-   if ( _pre_clearance  ) 
-    {
-      compute_clearance ();
+   if ( _updating )
+    { _finish_update (); // clearances, location grid and signatures of the region
+      _updating = false;
+    }
+   else
+    { if ( _pre_clearance ) compute_clearance ();
+      _build_locgrid ();
+      _save_facesigs ();
     }
+   _compact_ids (); // after many polygon edits
 
+   _edits.size ( 0 );
+   _editall = false;
    _dcdt_changed = false;
 
    return nref;
@@ -449,8 +666,6 @@ SeDcdtSymEdge* SeLct::_needs_refinement ( SeDcdtSymEdge* s, RefinementType type,
 
 int SeLct::refine ( RefinementType type, int maxiter, int* niter )
  {
-   SeEdge* e;
-   SeEdge* ei;
    SeDcdtSymEdge *s;
    SeDcdtSymEdge *sub;
    SeDcdtSymEdge *dv;
@@ -465,24 +680,25 @@ int SeLct::refine ( RefinementType type, int maxiter, int* niter )
    if ( niter ) *niter = 0;
    # define NITER (maxiter<0 ? (-i-1) : (maxiter-i))
 
+   // After the first scan only the faces near the inserted vertices are tested again, and a
+   // last scan confirms that no refinement is left, so that the work follows the refinements.
+   bool scan = true;
+   _reffaces.size(0);
    while ( i!=0 ) // if maxiter<0 the loop will only stop when refinement is concluded
     { _earray.size(0);
-      ei = e = _backface->se()->edg();
-
-      // collect all symedges to be fixed:
-      do { s = (SeDcdtSymEdge*)e->se();
-           sub = _needs_refinement(s,type,dv);
-           if ( sub ) { _earray.push()=s; _earray.push()=sub; _earray.push()=dv; }
-           else
-            { s = s->sym();
-              sub = _needs_refinement(s,type,dv);
-              if ( sub ) { _earray.push()=s; _earray.push()=sub; _earray.push()=dv; }
-            }
-           e = e->nxt();
-         } while ( e!=ei );
+
+      // collect all symedges to be fixed, or only the ones near the changed faces:
+      if ( !scan ) _collect_neighbour_refinements ( type );
+      else if ( _updating ) _collect_refinements ( type );
+      else _collect_all_refinements ( type );
 
       // if traversed all edges without subdivisions needed: done.
-      if ( _earray.empty() ) break;
+      if ( _earray.empty() )
+       { if ( scan ) break;
+         scan = true;
+         continue;
+       }
+      scan = false;
 
       i--;
       GS_TRACE2 ( "Iteration: "<<NITER<<" Disturbs: "<<(_earray.size()/3) );
@@ -499,9 +715,14 @@ int SeLct::refine ( RefinementType type, int maxiter, int* niter )
             SeVertex* v = insert_point_in_edge ( sub->edg(), p.x, p.y );
             if ( !v ) { gsout.warning("failure in refinement"); return false; }
             ((SeDcdtVertex*)v)->refinement = 1; 
+            if ( _updating ) _updverts.push()=(SeDcdtVertex*)v;
+            _refine_neighbours ( (SeDcdtVertex*)v );
             nref++;
           }
        }
+
+      // the new faces extend the region to check in the next iteration:
+      if ( _updating ) _find_new_changes ();
     }
 
    if ( niter ) { *niter = NITER; }
@@ -511,42 +732,41 @@ int SeLct::refine ( RefinementType type, int maxiter, int* niter )
    gsout<<"Time: "<<(gs_time()-t0)<<"s\n";
    #endif GS_USE_TRACE2
 
+   if ( nref>0 && !_updating ) _editall=true; // the face signatures no longer describe the mesh
+
    return nref;
  }
 
-void SeLct::compute_clearance ()
+void SeLct::_face_clearance ( SeDcdtFace* f )
  {
-   SeDcdtFace* f;
    SeDcdtSymEdge* s;
 
    #define SETC(s,v) if(s->edg()->se()==s) s->edg()->ca=(float)v; else s->edg()->cb=(float)v
 
-   for ( f=_backface->nxt(); f!=_backface; f=f->nxt() )
-    { s = f->se();
-      SeDcdtSymEdge * sn = s->nxt();
-      SeDcdtSymEdge * sp = sn->nxt();
-      if ( s->vtx()->border || sn->vtx()->border || sp->vtx()->border ) continue;
+   s = f->se();
+   SeDcdtSymEdge * sn = s->nxt();
+   SeDcdtSymEdge * sp = sn->nxt();
+   if ( s->vtx()->border || sn->vtx()->border || sp->vtx()->border ) return;
 
-      const GsPnt2& a = s->vtx()->p;
-      const GsPnt2& b = sn->vtx()->p;
-      const GsPnt2& c = sp->vtx()->p;
+   const GsPnt2& a = s->vtx()->p;
+   const GsPnt2& b = sn->vtx()->p;
+   const GsPnt2& c = sp->vtx()->p;
 
-      double dac=dist2(a,c);
-      double dab=dist2(a,b);
-      double dbc=dist2(b,c);
+   double dac=dist2(a,c);
+   double dab=dist2(a,b);
+   double dbc=dist2(b,c);
 
-      double ma = GS_MIN(dab,dac);
-      double mb = GS_MIN(dab,dbc);
-      double mc = GS_MIN(dac,dbc);
+   double ma = GS_MIN(dab,dac);
+   double mb = GS_MIN(dab,dbc);
+   double mc = GS_MIN(dac,dbc);
 
-      ma = _sector_clearance ( sn, ma, a, b, c );
-      mb = _sector_clearance ( sp, mb, b, c, a );
-      mc = _sector_clearance ( s,  mc, c, a, b );
+   ma = _sector_clearance ( sn, ma, a, b, c );
+   mb = _sector_clearance ( sp, mb, b, c, a );
+   mc = _sector_clearance ( s,  mc, c, a, b );
 
-      SETC(s,ma);
-      SETC(sn,mb);
-      SETC(sp,mc);
-    }
+   SETC(s,ma);
+   SETC(sn,mb);
+   SETC(sp,mc);
 
    #undef SETC
  }
@@ -632,6 +852,7 @@ void SeLct::_clear_path ()
    _ent[3].type = EntBlocked;
    _path_result = NoPath;
    _maxfronts = 0;
+   _expanded[0] = _expanded[1] = 0;
    _fi = 0;
  }
 
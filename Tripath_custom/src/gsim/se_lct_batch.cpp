@@ -0,0 +1,177 @@
+/*=======================================================================
+   Copyright 2010 Marcelo Kallmann. All Rights Reserved.
+   This software is distributed for noncommercial use only, without
+   any warranties, and provided that all copies contain the full copyright
+   notice licence.txt located at the base folder of the distribution. 
+  =======================================================================*/
+
+# include <thread>
+# include <mutex>
+# include <condition_variable>
+# include <gsim/se_lct_batch.h>
+
+//=============================== SeLctBatch::Pool ==================================
+
+struct SeLctBatch::Pool
+ { struct Worker { SeLctQuery* lct;
+                   std::mutex m;     // protects beg and end
+                   int beg, end;     // range of queries still to be solved
+                   std::thread t;
+                 };
+   GsArray<Worker*> w;
+   std::mutex m;                     // protects the batch state below
+   std::condition_variable start, done;
+   unsigned gen;                     // incremented at each new batch
+   int running;                      // workers still running in the current batch
+   int found;
+   bool quit;
+   const GsArray<Query>* q;
+   float* lens;
+   GsPolygon* paths;
+   float dang;
+
+   int next ( int i );
+   bool solve ( int i, int k );
+   void work ( int i );
+ };
+
+// returns the next query to be solved by worker i, stealing from other workers
+// when its range is empty; locks are never nested
+int SeLctBatch::Pool::next ( int i )
+ {
+   Worker* me = w[i];
+   { std::lock_guard<std::mutex> lk ( me->m );
+     if ( me->beg<me->end ) return me->beg++;
+   }
+
+   int j, k, n;
+   for ( j=1; j<w.size(); j++ )
+    { Worker* v = w[(i+j)%w.size()];
+      { std::lock_guard<std::mutex> lk ( v->m );
+        n = v->end-v->beg;
+        if ( n<=0 ) continue;
+        k = v->end-(n-n/2); // take the second half, at least one query
+        v->end = k;
+      }
+      std::lock_guard<std::mutex> lk ( me->m );
+      me->beg = k+1;
+      me->end = k+(n-n/2);
+      return k;
+    }
+   return -1;
+ }
+
+bool SeLctBatch::Pool::solve ( int i, int k )
+ {
+   const Query& qk = q->cget(k);
+   SeLctQuery* lct = w[i]->lct;
+
+   if ( lct->search_channel ( qk.x1, qk.y1, qk.x2, qk.y2, qk.radius ) )
+    { lens[k] = lct->funnel_path_length ( qk.radius );
+      if ( paths ) lct->make_funnel_path ( paths[k], qk.radius, dang );
+      return true;
+    }
+
+   if ( paths ) paths[k].size ( 0 );
+   lens[k] = -1.0f;
+   return false;
+ }
+
+void SeLctBatch::Pool::work ( int i )
+ {
+   unsigned seen = 0;
+   int k, nf;
+
+   while ( true )
+    { { std::unique_lock<std::mutex> lk ( m );
+        while ( !quit && gen==seen ) start.wait ( lk );
+        if ( quit ) return;
+        seen = gen;
+      }
+
+      nf = 0;
+      while ( (k=next(i))>=0 ) if ( solve(i,k) ) nf++;
+
+      std::lock_guard<std::mutex> lk ( m );
+      found += nf;
+      if ( --running==0 ) done.notify_one();
+    }
+ }
+
+//=============================== SeLctBatch ==================================
+
+SeLctBatch::SeLctBatch ( SeLct* lct, int nthreads )
+ {
+   if ( nthreads<=0 ) nthreads = (int)std::thread::hardware_concurrency();
+   if ( nthreads<=0 ) nthreads = 1;
+
+   _pool = new Pool;
+   _pool->gen = 0;
+   _pool->running = 0;
+   _pool->found = 0;
+   _pool->quit = false;
+   _pool->q = 0;
+   _pool->lens = 0;
+   _pool->paths = 0;
+   _pool->dang = 0;
+
+   int i;
+   for ( i=0; i<nthreads; i++ ) // contexts are created before any thread starts
+    { Pool::Worker* wk = new Pool::Worker;
+      wk->lct = new SeLctQuery ( lct );
+      wk->beg = wk->end = 0;
+      _pool->w.push() = wk;
+    }
+   for ( i=0; i<nthreads; i++ )
+    _pool->w[i]->t = std::thread ( &Pool::work, _pool, i );
+ }
+
+SeLctBatch::~SeLctBatch ()
+ {
+   { std::lock_guard<std::mutex> lk ( _pool->m );
+     _pool->quit = true;
+   }
+   _pool->start.notify_all();
+
+   for ( int i=0; i<_pool->w.size(); i++ )
+    { Pool::Worker* wk = _pool->w[i];
+      wk->t.join();
+      delete wk->lct;
+      delete wk;
+    }
+   delete _pool;
+ }
+
+int SeLctBatch::threads () const
+ {
+   return _pool->w.size();
+ }
+
+int SeLctBatch::run ( const GsArray<Query>& queries, GsArray<float>& lens, GsPolygon* paths, float dang )
+ {
+   int n = queries.size();
+   lens.size ( n );
+   if ( n==0 ) return 0;
+
+   int i, nw = _pool->w.size();
+   std::unique_lock<std::mutex> lk ( _pool->m );
+   _pool->q = &queries;
+   _pool->lens = &lens[0];
+   _pool->paths = paths;
+   _pool->dang = dang;
+   _pool->found = 0;
+   for ( i=0; i<nw; i++ )
+    { Pool::Worker* wk = _pool->w[i];
+      std::lock_guard<std::mutex> wl ( wk->m );
+      wk->beg = int ( (long long)n*i/nw );
+      wk->end = int ( (long long)n*(i+1)/nw );
+    }
+   _pool->running = nw;
+   _pool->gen++;
+   _pool->start.notify_all();
+
+   while ( _pool->running>0 ) _pool->done.wait ( lk );
+   return _pool->found;
+ }
+
+//============================ End of File ===============================
@@ -0,0 +1,244 @@
+/*=======================================================================
+   Copyright 2010 Marcelo Kallmann. All Rights Reserved.
+   This software is distributed for noncommercial use only, without
+   any warranties, and provided that all copies contain the full copyright
+   notice licence.txt located at the base folder of the distribution.
+  =======================================================================*/
+
+# include <math.h>
+
+# include <gsim/gs_geo2.h>
+
+# include <gsim/se_lct.h>
+# include "se_triangulator_internal.h"
+
+# define GS_TRACE_ONLY_LINES
+//# define GS_USE_TRACE1 // main search method
+//# define GS_USE_TRACE2 // meetings
+# include <gsim/gs_trace.h>
+
+# define ExpansionNotFinished  -1
+# define ExpansionBlocked      -2
+
+//================================================================================
+//========================= bidirectional search =================================
+//================================================================================
+
+// index of the directed edge of s: edge id and direction
+static int dedge ( SeBase* s )
+ {
+   SeDcdtEdge* e = ((SeDcdtSymEdge*)s)->edg();
+   return 2*e->id() + (s==e->se()? 0:1);
+ }
+
+static void grow ( GsArray<int>& a, int n )
+ {
+   int i = a.size();
+   if ( i>=n ) return;
+   a.size ( n );
+   while ( i<n ) a[i++]=-1;
+ }
+
+// The backward search runs the forward methods over swapped endpoints, trees, start triangles
+// and landmark bounds, so that the clearance, departure and arrival tests are mirrored.
+void SeLct::_biswap ()
+ {
+   PathTree* t=_ptree; _ptree=_bi->tree; _bi->tree=t;
+   double d;
+   d=_xi; _xi=_xg; _xg=d;
+   d=_yi; _yi=_yg; _yg=d;
+   SeFace* f=_fi; _fi=_bi->fg; _bi->fg=f;
+   GsArray<float> lm;
+   lm.adopt ( _lmgoal );
+   _lmgoal.adopt ( _bi->lmgoal );
+   _bi->lmgoal.adopt ( lm );
+   _bi->backward = !_bi->backward;
+ }
+
+// Tests if the channel joining the forward node f and the backward node b, which cross the same
+// edge in opposite directions, traverses each triangle once, and stores it in _channel if build
+// is true. With f=-1 the backward node b is the one entering the start triangle.
+bool SeLct::_bichannel ( int f, int b, bool build )
+ {
+   PathTree* ft = _bi->backward? _bi->tree:_ptree;
+   PathTree* bt = _bi->backward? _ptree:_bi->tree;
+   GsArray<int>& onpath = _bi->onpath;
+   int n, ps = ++_bi->pstamp;
+
+   if ( f<0 ) onpath[bt->nodes[b].ex->sym()->fac()->id()]=ps;
+   for ( n=f; n>=0; n=ft->nodes[n].parent ) onpath[ft->nodes[n].en->fac()->id()]=ps;
+   for ( n=b; n>=0; n=bt->nodes[n].parent )
+    { if ( onpath[bt->nodes[n].en->fac()->id()]==ps ) return false;
+    }
+   if ( !build ) return true;
+
+   _channel.size(0);
+   for ( n=f; n>=0; n=ft->nodes[n].parent ) _channel.push()=ft->nodes[n].ex;
+   _channel.revert();
+   if ( f<0 ) _channel.push()=bt->nodes[b].ex->sym();
+   for ( n=b; bt->nodes[n].parent>=0; n=bt->nodes[n].parent ) _channel.push()=bt->nodes[n].en;
+   return true;
+ }
+
+// The ends of a channel found by the backward search were only tested in the backward direction,
+// so its departure must be open in the entrance analysis of the start, and the arrival analysis
+// needed by the funnel is computed as the forward search does. Must be called in forward state.
+bool SeLct::_bichannelends ()
+ {
+   int k = _channel[0]==_ent[0].s? 0 : _channel[0]==_ent[1].s? 1 : _channel[0]==_ent[2].s? 2:-1;
+   if ( k<0 || _ent[k].type==EntBlocked ) return false;
+
+   // last traversal of the channel, entering the triangle before the goal one:
+   int n = _channel.size();
+   SeDcdtSymEdge* ex = (SeDcdtSymEdge*)_channel[n-1];
+   SeDcdtSymEdge* en = n>1? (SeDcdtSymEdge*)_channel[n-2]->sym() : _ent[k].top? ex->nxt():ex->nxn();
+   _analyze_arrival ( ex->sym(), 3, _ptree->radius, _ptree->diam2, en, ex );
+   return _ent[3].type!=EntBlocked;
+ }
+
+// Records node i of the active tree as the cheapest crossing of its exit edge, if so, and joins it
+// to the cheapest node of the other tree crossing the same edge in the opposite direction. The
+// cheapest meeting traversing each triangle once is kept in best, with its nodes in bf and bb.
+void SeLct::_bimeet ( int i, float& best, int& bf, int& bb )
+ {
+   const PathNode& n = _ptree->nodes[i];
+   if ( n.parent<0 ) return; // departures are only joined by the arrival tests
+   int t = _bi->backward? 1:0;
+
+   BiSearch::Cross& c = _bi->crossed[dedge(n.ex)];
+   if ( c.stamp[t]!=_bi->stamp || n.ncost<_ptree->nodes[c.node[t]].ncost )
+    { c.stamp[t]=_bi->stamp; c.node[t]=i; }
+
+   const BiSearch::Cross& o = _bi->crossed[dedge(n.ex->sym())];
+   if ( o.stamp[1-t]!=_bi->stamp ) return;
+   const PathNode& m = _bi->tree->nodes[o.node[1-t]];
+   float cost = n.ncost + m.ncost + float(sqrt(gs_dist2(n.x,n.y,m.x,m.y)));
+   if ( best>=0 && cost>=best ) return;
+
+   int f = t? o.node[0]:i;
+   int b = t? i:o.node[1];
+   if ( !_bichannel(f,b,false) ) return;
+   GS_TRACE2 ( "Meeting "<<f<<" "<<b<<" cost "<<cost );
+   best=cost; bf=f; bb=b;
+ }
+
+/* - Returns 1 if a channel was found, 0 if there is no path, and -1 if the query must be solved
+     by the forward search: local queries, and channels rejected by the departure or arrival tests. */
+int SeLct::_bisearch_channel ( double x1, double y1, double x2, double y2, float radius, const SeFace* iniface )
+ {
+   GS_TRACE1 ( "Starting Bidirectional Search..." );
+
+   if ( !_ptree ) _ptree = new PathTree;
+   if ( !_bi )
+    { _bi = new BiSearch;
+      _bi->tree = new PathTree;
+      _bi->fg = 0;
+      _bi->backward = false;
+      _bi->stamp = _bi->pstamp = 0;
+    }
+   _clear_path();
+
+   _channel.size(0);
+   _xi=x1; _yi=y1; _xg=x2; _yg=y2;
+
+   if ( !iniface ) return 0;
+
+   SeBase *s, *sg;
+   LocateResult res=locate_point ( iniface, x1, y1, s );
+   if ( res==NotFound ) return 0;
+   if ( _man->in_triangle(s->vtx(),s->nxt()->vtx(),s->nxn()->vtx(),x2,y2) ) return -1;
+   _fi = s->fac();
+   if ( !pt1circfree(this,s,x1,y1,radius) ) return 0;
+
+   // the goal is validated here, instead of when the search reaches its triangle:
+   LocateResult resg=locate_point ( _locseed(x2,y2), x2, y2, sg );
+   if ( resg==NotFound ) return 0;
+   if ( !pt2circfree(this,sg,x2,y2,radius) ) return 0;
+
+   // departures from the goal, and then from the start, which are kept for the funnel:
+   int k;
+   _analyze_entrances ( sg, x2, y2, radius );
+   SeDcdtSymEdge* gs[3];
+   bool gtop[3], gopen[3];
+   for ( k=0; k<3; k++ ) { gs[k]=_ent[k].s; gtop[k]=_ent[k].top; gopen[k]=_ent[k].type!=EntBlocked; }
+   _analyze_entrances ( s, x1, y1, radius );
+
+   GS_TRACE1 ( "Initializing both A* searches..." );
+   int ni = _mesh->idbound();
+   grow ( _bi->visited, ni );
+   grow ( _bi->onpath, ni );
+   if ( _bi->crossed.size()<2*ni )
+    { int i = _bi->crossed.size();
+      _bi->crossed.size ( 2*ni );
+      while ( i<2*ni ) { _bi->crossed[i].stamp[0]=_bi->crossed[i].stamp[1]=-1; i++; }
+    }
+   _bi->stamp++;
+
+   _lmsetgoal ( s, x1, y1, x2, y2, radius );
+   _ptree->init ( radius );
+   for ( k=0; k<3; k++ )
+    { if ( _ent[k].type!=EntBlocked ) _ptreeaddent ( _ent[k].s, _ent[k].top, k==0 && res==EdgeFound );
+    }
+   _bi->fg = sg->fac();
+   _biswap ();
+   _lmsetgoal ( sg, x2, y2, x1, y1, radius );
+   _ptree->init ( radius );
+   for ( k=0; k<3; k++ )
+    { if ( gopen[k] ) _ptreeaddent ( gs[k], gtop[k], k==0 && resg==EdgeFound );
+    }
+   _biswap ();
+   _begin_marking ();
+
+   if (_searchcb) _searchcb(_sudata);
+
+   GS_TRACE1 ( "Expanding leafs..." );
+   int found=ExpansionNotFinished, bf=-1, bb=-1;
+   float best=-1;
+   while ( true )
+    { PathTree* ft = _bi->backward? _bi->tree:_ptree;
+      PathTree* bt = _bi->backward? _ptree:_bi->tree;
+      if ( ft->leafs.empty() || bt->leafs.empty() ) break; // no other meeting can be found
+      if ( best>=0 && best<=GS_MAX(ft->leafs.lowest_cost(),bt->leafs.lowest_cost()) ) break;
+      if ( (bt->leafs.size()<ft->leafs.size())!=_bi->backward ) _biswap ();
+      int nsize = _ptree->nodes.size();
+      found = _expand_lowest_cost_leaf ();
+      if ( found!=ExpansionNotFinished ) break; // arrived at the other point, or blocked
+      for ( int i=nsize; i<_ptree->nodes.size(); i++ ) _bimeet ( i, best, bf, bb );
+    }
+
+   // a direct arrival is used if not costlier than the best meeting:
+   bool backward = _bi->backward;
+   if ( found>=0 )
+    { const PathNode& n = _ptree->nodes[found];
+      float cost = n.ncost + float(sqrt(gs_dist2(n.x,n.y,_xg,_yg)));
+      if ( best>=0 && best<cost ) found=ExpansionNotFinished;
+    }
+   if ( backward ) _biswap ();
+
+   int result = 1;
+   if ( found>=0 && !backward ) // the forward search arrived at the goal, as in _search_channel()
+    { _finalsearchnode = found;
+      for ( int n=found; n!=-1; n=_ptree->nodes[n].parent ) _channel.push()=_ptree->nodes[n].ex;
+      _channel.revert();
+    }
+   else if ( found>=0 || best>=0 )
+    { if ( found>=0 ) { bf=-1; bb=found; }
+      _finalsearchnode = bf;
+      _bichannel ( bf, bb, true );
+      if ( !_bichannelends() ) { GS_TRACE1 ( "Channel ends are blocked." ); result=-1; }
+    }
+   else // a backward arrival blocked at the start is left to the departure tests of the forward search
+    { result = found==ExpansionBlocked && backward? -1:0;
+    }
+
+   _end_marking ();
+
+   GS_TRACE1 ( "Expanded nodes: "<<_expanded[0]<<" forward, "<<_expanded[1]<<" backward." );
+   if ( result<=0 ) { _channel.size(0); return result; }
+
+   GS_TRACE1 ( "Path crosses "<<_channel.size()<<" edges." );
+   _path_result = GlobalPath;
+   return 1;
+ }
+
+//============================ End of File =================================
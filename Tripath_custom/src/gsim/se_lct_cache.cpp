@@ -0,0 +1,221 @@
+/*=======================================================================
+   Copyright 2010 Marcelo Kallmann. All Rights Reserved.
+   This software is distributed for noncommercial use only, without
+   any warranties, and provided that all copies contain the full copyright
+   notice licence.txt located at the base folder of the distribution.
+  =======================================================================*/
+
+# include <math.h>
+# include <gsim/se_lct_cache.h>
+
+//================================ SeLctCache ====================================
+
+// GsPolygon has no copy operator, so the points are copied with the one of GsArray
+static void copypath ( GsPolygon& dest, const GsPolygon& src )
+ {
+   (GsArray<GsPnt2>&)dest = src;
+   dest.open ( src.open() );
+ }
+
+SeLctCache::SeLctCache ( int capacity, float quantum )
+ {
+   _entries = 0;
+   _capacity = 0;
+   _version = 0;
+   _quantum = quantum>0? quantum:0.001f;
+   _hits = _misses = 0;
+   SeLctCache::capacity ( capacity );
+ }
+
+SeLctCache::~SeLctCache ()
+ {
+   delete[] _entries;
+ }
+
+void SeLctCache::capacity ( int c )
+ {
+   if ( c<0 ) c=0;
+   if ( c!=_capacity )
+    { delete[] _entries;
+      _capacity = c;
+      _entries = c? new Entry[c] : 0;
+      int nb=16; // power of two with at least two buckets per entry
+      while ( nb<2*c ) nb*=2;
+      _buckets.size ( c? nb:0 );
+      _buckets.compress ();
+    }
+   clear ();
+ }
+
+void SeLctCache::quantum ( float q )
+ {
+   if ( q>0 ) _quantum=q;
+   clear ();
+ }
+
+void SeLctCache::clear ()
+ {
+   _size = 0;
+   _first = _last = -1;
+   _buckets.setall ( -1 );
+   _free = _capacity? 0:-1; // all entries in the free list
+   for ( int i=0; i<_capacity; i++ )
+    { _entries[i].hnext = i+1<_capacity? i+1:-1;
+      _entries[i].path.size ( 0 );
+      _entries[i].path.compress ();
+    }
+ }
+
+void SeLctCache::_key ( const SeLctBatch::Query& q, int* k ) const
+ {
+   k[0] = (int)floor ( q.x1/_quantum+0.5f );
+   k[1] = (int)floor ( q.y1/_quantum+0.5f );
+   k[2] = (int)floor ( q.x2/_quantum+0.5f );
+   k[3] = (int)floor ( q.y2/_quantum+0.5f );
+ }
+
+int SeLctCache::_bucket ( const int* k, float radius, int group ) const
+ {
+   unsigned h = (unsigned)group;
+   for ( int i=0; i<4; i++ ) h = h*2654435761u + (unsigned)k[i];
+   union { float f; unsigned u; } r;
+   r.f = radius;
+   h = h*2654435761u + r.u;
+   h ^= h>>15;
+   return int ( h & unsigned(_buckets.size()-1) );
+ }
+
+// returns the entry with the given key or -1, and its bucket in b
+int SeLctCache::_find ( const int* k, float radius, int group, int& b ) const
+ {
+   b = _bucket ( k, radius, group );
+   for ( int e=_buckets[b]; e>=0; e=_entries[e].hnext )
+    { const Entry& en = _entries[e];
+      if ( en.k[0]==k[0] && en.k[1]==k[1] && en.k[2]==k[2] && en.k[3]==k[3] &&
+           en.radius==radius && en.group==group ) return e;
+    }
+   return -1;
+ }
+
+void SeLctCache::_unlink ( int e )
+ {
+   Entry& en = _entries[e];
+   if ( en.prev>=0 ) _entries[en.prev].next=en.next; else _first=en.next;
+   if ( en.next>=0 ) _entries[en.next].prev=en.prev; else _last=en.prev;
+ }
+
+void SeLctCache::_pushfront ( int e )
+ {
+   Entry& en = _entries[e];
+   en.prev = -1;
+   en.next = _first;
+   if ( _first>=0 ) _entries[_first].prev=e; else _last=e;
+   _first = e;
+ }
+
+void SeLctCache::_check ( int version )
+ {
+   if ( version!=_version ) { clear(); _version=version; }
+ }
+
+// removes entry e from the recency list and from its hash bucket
+void SeLctCache::_drop ( int e )
+ {
+   _unlink ( e );
+   Entry& en = _entries[e];
+   int* p = &_buckets[_bucket(en.k,en.radius,en.group)];
+   while ( *p!=e ) p = &_entries[*p].hnext;
+   *p = en.hnext;
+   _size--;
+ }
+
+// distance from x,y to the box (xmin,ymin,xmax,ymax), 0 if inside
+static float boxdist ( float x, float y, const float* box )
+ {
+   float dx = x<box[0]? box[0]-x : x>box[2]? x-box[2] : 0;
+   float dy = y<box[1]? box[1]-y : y>box[3]? y-box[3] : 0;
+   return sqrtf ( dx*dx+dy*dy );
+ }
+
+bool SeLctCache::_affected ( const Entry& en, const float* box, bool removal ) const
+ {
+   if ( en.len<0 ) return removal; // inserting obstacles cannot create a path
+   // the quantized endpoints are less than a quantum away from the original ones:
+   float d = boxdist ( en.k[0]*_quantum, en.k[1]*_quantum, box ) +
+             boxdist ( en.k[2]*_quantum, en.k[3]*_quantum, box ) - 2.0f*_quantum;
+   // paths passing by the polygon come closer than the radius to its box at both sides:
+   float m = 2.0f*en.radius;
+   return removal? d-m<en.len : d<en.len+m;
+ }
+
+void SeLctCache::update ( int version, const GsPolygon& pol, bool removal )
+ {
+   if ( version!=_version+1 || pol.empty() ) { clear(); _version=version; return; }
+   _version = version;
+   float box[4];
+   pol.get_bounding_box ( box[0], box[1], box[2], box[3] );
+   int e, next;
+   for ( e=_first; e>=0; e=next )
+    { next = _entries[e].next;
+      if ( !_affected(_entries[e],box,removal) ) continue;
+      _drop ( e );
+      _entries[e].hnext = _free;
+      _free = e;
+    }
+ }
+
+bool SeLctCache::get ( int version, const SeLctBatch::Query& q, float& len, GsPolygon* path, float dang, int group )
+ {
+   if ( !_capacity ) return false;
+   _check ( version );
+   int k[4], b;
+   _key ( q, k );
+   int e = _find ( k, q.radius, group, b );
+   if ( e<0 || (path && _entries[e].len>=0 && (_entries[e].dang<=0 || _entries[e].dang!=dang)) )
+    { _misses++; return false; }
+
+   _hits++;
+   const Entry& en = _entries[e];
+   len = en.len;
+   if ( path ) copypath ( *path, en.path );
+   if ( e!=_first ) { _unlink(e); _pushfront(e); }
+   return true;
+ }
+
+void SeLctCache::put ( int version, const SeLctBatch::Query& q, float len, const GsPolygon* path, float dang, int group )
+ {
+   if ( !_capacity ) return;
+   _check ( version );
+   int k[4], b;
+   _key ( q, k );
+   int e = _find ( k, q.radius, group, b );
+   if ( e>=0 ) // update
+    { _unlink ( e );
+    }
+   else
+    { if ( _free<0 ) // evict the least recently used entry
+       { e = _last;
+         _drop ( e );
+       }
+      else
+       { e = _free;
+         _free = _entries[e].hnext;
+       }
+      Entry& en = _entries[e];
+      for ( int i=0; i<4; i++ ) en.k[i]=k[i];
+      en.radius = q.radius;
+      en.group = group;
+      en.dang = 0;
+      en.path.size ( 0 );
+      en.hnext = _buckets[b];
+      _buckets[b] = e;
+      _size++;
+    }
+
+   Entry& en = _entries[e];
+   en.len = len;
+   if ( path ) { copypath(en.path,*path); en.dang=dang; } // otherwise a path already stored is kept
+   _pushfront ( e );
+ }
+
+//============================ End of File =================================
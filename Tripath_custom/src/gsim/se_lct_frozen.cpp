@@ -0,0 +1,186 @@
+/*=======================================================================
+   Copyright 2010 Marcelo Kallmann. All Rights Reserved.
+   This software is distributed for noncommercial use only, without
+   any warranties, and provided that all copies contain the full copyright
+   notice licence.txt located at the base folder of the distribution.
+  =======================================================================*/
+
+# include <math.h>
+
+# include <gsim/gs_geo2.h>
+
+# include <gsim/se_lct.h>
+# include "se_triangulator_internal.h"
+
+# define GS_TRACE_ONLY_LINES
+//# define GS_USE_TRACE1 // goal arrival
+# include <gsim/gs_trace.h>
+
+# define ExpansionNotFinished  -1
+# define ExpansionBlocked      -2
+
+// next half-edge in the same triangle:
+# define NXT(h) ( (h)%3==2? (h)-2:(h)+1 )
+
+//================================================================================
+//============================== frozen mesh =====================================
+//================================================================================
+
+int SeLct::compute_frozen_mesh ()
+ {
+   clear_frozen_mesh ();
+   if ( _dcdt_changed ) refine ();
+   if ( !_pre_clearance || !_backface ) return 0; // the searches only use it with precomputed clearances
+
+   _frz = new FrozenMesh;
+   _frz->ref ();
+   FrozenMesh& fm = *_frz;
+   int ni = _mesh->idbound();
+
+   // vertices, in the order of the vertex list:
+   GsArray<int> vid ( ni );
+   SeDcdtVertex *v, *vi;
+   v = vi = ((SeDcdtSymEdge*)_backface->se())->vtx();
+   do { vid[v->id()] = fm.pts.size();
+        fm.pts.push() = v->p;
+        v = v->nxt();
+      } while ( v!=vi );
+
+   // triangles, in the order of the face list:
+   SeDcdtFace* f;
+   int t=0, h, k;
+   fm.tri.size ( ni );
+   fm.tri.setall ( -1 );
+   for ( f=_backface->nxt(); f!=_backface; f=f->nxt() ) fm.tri[f->id()]=t++;
+
+   int nh = 3*t;
+   fm.vtx.size ( nh );
+   fm.sym.size ( nh );
+   fm.cl.size ( nh );
+   fm.con.size ( nh );
+   fm.se.size ( nh );
+   for ( h=0, f=_backface->nxt(); f!=_backface; f=f->nxt() )
+    { SeDcdtSymEdge* s = f->se();
+      for ( k=0; k<3; k++, h++, s=s->nxt() )
+       { fm.se[h] = s;
+         fm.vtx[h] = vid[s->vtx()->id()];
+         fm.cl[h] = s->edg()->cl(s);
+         fm.con[h] = _man->is_constrained(s->edg())? 1:0;
+       }
+    }
+   for ( h=0; h<nh; h++ )
+    { SeDcdtSymEdge* y = fm.se[h]->sym();
+      int u = fm.tri[y->fac()->id()];
+      fm.sym[h] = u<0? -1 : _frzhalfedge(y);
+    }
+
+   return t;
+ }
+
+void SeLct::clear_frozen_mesh ()
+ {
+   if ( _frz ) _frz->unref (); // query contexts may still reference it
+   _frz = 0;
+ }
+
+// half-edge of symedge s, which must be in a triangle
+int SeLct::_frzhalfedge ( SeBase* s ) const
+ {
+   int h = 3*_frz->tri[s->fac()->id()];
+   while ( _frz->se[h]!=s ) h++;
+   return h;
+ }
+
+// starts the expansion over the frozen mesh, after the entrance nodes were added
+void SeLct::_frzbegin ()
+ {
+   int nt = _frz->sym.size()/3;
+   if ( _frzvisit.size()!=nt ) { _frzvisit.size(nt); _frzvisit.setall(0); _frzstamp=0; }
+   _frzstamp++;
+   _frzfi = _frz->tri[_fi->id()];
+   _frzhe.size ( 0 );
+   for ( int i=0; i<_ptree->nodes.size(); i++ )
+    { _frzhe.push() = _frzhalfedge ( _ptree->nodes[i].en );
+      _frzhe.push() = _frzhalfedge ( _ptree->nodes[i].ex );
+    }
+ }
+
+// Same as _trytoadd() for single-goal searches with precomputed clearances, where en and ex are
+// half-edges of the triangle expanded by node mi, which was already tested as not visited.
+void SeLct::_frztrytoadd ( int en, int ex, int mi, const GsPnt2& p1, const GsPnt2& p2, const GsPnt2& p3 )
+ {
+   const FrozenMesh& fm = *_frz;
+   if ( fm.con[ex] ) return;
+
+   float d2 = _ptree->diam2;
+   int nen = _frzhe[2*mi];
+   int nex = _frzhe[2*mi+1];
+   bool bot = NXT(en)==ex;
+   if ( fm.cl[bot? ex:en]<d2 ) return;
+   if ( nex/3==_frzfi && (bot? NXT(nex)==nen : NXT(nen)==nex) ) // departure transition
+    { if ( !_local_transition_free(fm.se[ex],fm.se[en],d2,_xi,_yi) ) return;
+    }
+
+   PathNode& n = _ptree->nodes[mi];
+   double x, y;
+   if ( bot )
+    _getcostpoint ( &n, n.x, n.y, p2.x, p2.y, p3.x, p3.y, x, y, _ptree->radius );
+   else
+    _getcostpoint ( &n, n.x, n.y, p3.x, p3.y, p1.x, p1.y, x, y, _ptree->radius );
+   float h = _heuristic ( fm.se[ex], x, y );
+   if ( h<0 ) return; // the landmarks show that the goal cannot be reached from ex
+   # define PTDIST(a,b,c,d) float(sqrt(gs_dist2(a,b,c,d)))
+   _ptree->add_child ( mi, fm.se[en], fm.se[ex], n.ncost+PTDIST(n.x,n.y,x,y), h, x,y );
+   # undef PTDIST
+   _frzhe.push() = en;
+   _frzhe.push() = ex;
+ }
+
+// Same as _expand_lowest_cost_leaf() for single-goal searches, reading the triangle to expand,
+// its clearances and visited state from the frozen arrays; the arrival uses the mesh.
+int SeLct::_frz_expand_lowest_cost_leaf ()
+ {
+   if ( _ptree->leafs.size()>_maxfronts ) _maxfronts=_ptree->leafs.size();
+
+   int min_i = _ptree->lowest_cost_leaf ();
+   if ( min_i<0 ) return ExpansionBlocked; // no more leafs: path could not be found!
+   _expanded[0]++;
+
+   const FrozenMesh& fm = *_frz;
+   int s = fm.sym[_frzhe[2*min_i+1]]; // s is in the triangle to expand
+   int sn = NXT(s);
+   int sp = NXT(sn);
+   const GsPnt2& p1 = fm.pts[fm.vtx[s]];
+   const GsPnt2& p2 = fm.pts[fm.vtx[sn]];
+   const GsPnt2& p3 = fm.pts[fm.vtx[sp]];
+
+   if ( gs_in_triangle(p1.x,p1.y,p2.x,p2.y,p3.x,p3.y,_xg,_yg) ) // reached goal triangle
+    { GS_TRACE1 ( "Goal triangle reached..." );
+      double r = _ptree->radius;
+      float d2 = _ptree->diam2;
+      if ( !pt2circfree(this,fm.se[s],_xg,_yg,r) ) return ExpansionBlocked;
+      _analyze_arrival ( fm.se[s], 3, r, d2, (SeDcdtSymEdge*)_ptree->nodes[min_i].en, (SeDcdtSymEdge*)_ptree->nodes[min_i].ex );
+      if ( _ent[3].type!=EntBlocked ) return min_i; // found
+      if ( (fm.con[sn]||dist2(p2,p3)<d2) && (fm.con[sp]||dist2(p3,p1)<d2) )
+       { GS_TRACE1 ( "Arrival blocked from all possible entries." );
+         return ExpansionBlocked;
+       }
+      // otherwise the search continues, and the arrival triangle may still be a passage
+    }
+
+   int t = s/3;
+   if ( _frzvisit[t]!=_frzstamp )
+    { int nsize = _ptree->nodes.size();
+      _frztrytoadd ( s, sn, min_i, p1, p2, p3 ); // bot
+      _frztrytoadd ( s, sp, min_i, p1, p2, p3 ); // top
+      if ( _ptree->nodes.size()>nsize ) _frzvisit[t]=_frzstamp; // only mark traversed faces
+    }
+
+   if (_searchcb) _searchcb(_sudata);
+
+   return ExpansionNotFinished; // continue the expansion
+ }
+
+# undef NXT
+
+//============================ End of File ===============================
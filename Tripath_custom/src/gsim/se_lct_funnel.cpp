@@ -365,6 +365,60 @@ void SeLct::_fpathmake ( FunnelPath* fpath, GsPolygon& path, float radius, float
    path.push() = fpath->top();
  }
 
+// same traversal as _fpathmake(), but only accumulating the length of each tangent
+// segment and of each arc, which is exact instead of the one of the arc polygon
+float SeLct::_fpathlen ( FunnelPath* fpath )
+ {
+   if ( fpath->size()==2 ) return dist ( fpath->get(0), fpath->top() );
+
+   GsPnt2 lp ( fpath->get(1) );
+   tangents ( 'p', fpath->get(1).optop(), fpath->get(0), lp, 0, fpath->get(1).dist );
+   float len = dist ( fpath->get(0), lp );
+
+   int size = fpath->size();
+   char code[2];
+   float ra, rb;
+   GsPnt2 a, b;
+   for ( int i=2; i<size; i++ )
+    {
+      a=fpath->get(i-1); b=fpath->get(i);
+      ra=fpath->get(i-1).dist; rb=fpath->get(i).dist;
+      code[0]=fpath->get(i-1).optop();
+      code[1]=fpath->get(i).opside();
+      tangents ( code[0], code[1], a, b, ra, rb );
+      GsPnt2& cent = fpath->get(i-1);
+      len += ra*angle(lp-cent,a-cent) + dist(a,b);
+      lp=b;
+    }
+   return len;
+ }
+
+// length of the local path built in make_funnel_path() around the entrance disturbances
+float SeLct::_flocallen ( float radius )
+ {
+   GsArray<GsPnt2>& fp = _ent[0].fp;
+   bool top = _ent[0].top;
+   GsPnt2 lp ( (float)_xi, (float)_yi );
+   GsVec2 c, v1, v2;
+   float len=0;
+   int k, max = fp.size()-2;
+   for ( k=0; k<max; k++ )
+    { c = fp[k+1];
+      if ( top )
+       { v1 = (fp[k]-c).ortho();
+         v2 = (c-fp[k+2]).ortho();
+       }
+      else
+       { v1 = (c-fp[k]).ortho();
+         v2 = (fp[k+2]-c).ortho();
+       }
+      v1.len(radius); v2.len(radius);
+      len += dist(lp,c+v1) + radius*angle(v1,v2);
+      lp = c+v2;
+    }
+   return len + dist ( lp, GsPnt2((float)_xg,(float)_yg) );
+ }
+
 void SeLct::_finitextcl ( float radius, float extclear )
  {
    SeDcdtSymEdge *s1, *s2;
@@ -512,7 +566,36 @@ void SeLct::make_funnel_path ( GsPolygon& path, float radius, float dang, float
 
    // ok from now on we are treating the global path search case:
    GS_TRACE1 ( "Computing global path..." );
+   _funnelrun ( radius, extclear );
+
+   // build path approximation based on tangents:
+   GS_TRACE1 ( "Building curved path approximation..." );
+   _fpathmake ( _fpath, path, radius, dang );
+
+   GS_TRACE1 ( "Done." );
+ }
+
+float SeLct::funnel_path_length ( float radius, float extclear )
+ {
+   if ( radius<=0 )
+    { GsPolygon path;
+      SeDcdt::make_funnel_path(path);
+      return path.size()>0? path.perimeter():-1.0f;
+    }
 
+   if ( _path_result==NoPath ) return -1.0f;
+
+   if ( _path_result==TrivialPath ) return dist ( GsPnt2((float)_xi,(float)_yi), GsPnt2((float)_xg,(float)_yg) );
+
+   if ( _path_result==LocalPath ) return _flocallen ( radius );
+
+   _funnelrun ( radius, extclear );
+   return _fpathlen ( _fpath );
+ }
+
+// runs the funnel algorithm along the current channel, leaving the path corners in _fpath
+void SeLct::_funnelrun ( float radius, float extclear )
+ {
    // allocate/access used buffers:
    // (we reset autolen to false since this is shared with the optimal search)
    if ( !_fpath ) _fpath = new FunnelPath(false); else { _fpath->size(0); _fpath->autolen=false; }
@@ -566,12 +649,6 @@ void SeLct::make_funnel_path ( GsPolygon& path, float radius, float dang, float
    GS_TRACE1 ( "Path has " << _fpath->size() << " vertices before closure." );
    GS_TRACE1 ( "Processing closure..." );
    _funnelclose ( _fdeque, _fpath, 3, radius );
-
-   // build path approximation based on tangents:
-   GS_TRACE1 ( "Building curved path approximation..." );
-   _fpathmake ( _fpath, path, radius, dang );
-
-   GS_TRACE1 ( "Done." );
  }
 
 void SeLct::get_path_corners ( GsArray<GsVec2>& points, GsArray<char>& topdown )
@@ -0,0 +1,236 @@
+/*=======================================================================
+   Copyright 2010 Marcelo Kallmann. All Rights Reserved.
+   This software is distributed for noncommercial use only, without
+   any warranties, and provided that all copies contain the full copyright
+   notice licence.txt located at the base folder of the distribution.
+  =======================================================================*/
+
+# include <math.h>
+# include <gsim/gs_heap.h>
+# include <gsim/gs_geo2.h>
+# include <gsim/se_lct.h>
+# include "se_triangulator_internal.h"
+
+//# define GS_USE_TRACE1 // route search
+# include <gsim/gs_trace.h>
+
+//================================================================================
+//============================= junction graph ===================================
+//================================================================================
+
+static GsPnt2 midpoint ( SeDcdtSymEdge* s )
+ {
+   const GsPnt2& a = s->vtx()->p;
+   const GsPnt2& b = s->nvtx()->p;
+   return GsPnt2 ( (a.x+b.x)/2.0f, (a.y+b.y)/2.0f );
+ }
+
+// squared clearance of the traversal of the triangle of en from en to ex, as tested by _canpass()
+static float travcl ( SeDcdtSymEdge* en, SeDcdtSymEdge* ex )
+ {
+   return en->nxt()==ex? ex->edg()->cl(ex) : en->edg()->cl(en);
+ }
+
+// edge k of the triangle of a junction
+static SeDcdtSymEdge* jedge ( SeDcdtSymEdge* s, int k )
+ {
+   return k==0? s : k==1? s->nxt() : s->nxn();
+ }
+
+// walks the corridor leaving junction j by its edge k until another junction or a dead end
+void SeLct::_jgcorridor ( int j, int k )
+ {
+   JunctionGraph& g = *_jg;
+   int ci = g.corrs.size();
+   JunctionGraph::Corridor& c = g.corrs.push();
+   c.j[0]=j; c.k[0]=(char)k;
+   c.j[1]=-1; c.k[1]=0;
+   c.fst=g.faces.size(); c.n=0;
+   c.width=-1.0f;
+   g.juncs[j].c[k]=ci;
+
+   SeDcdtSymEdge* t = jedge ( g.juncs[j].s, k );
+   GsPnt2 m = midpoint ( t );
+   c.len = 0;
+   t = t->sym();
+
+   while ( true )
+    { SeDcdtFace* f = t->fac();
+      int jf = g.jof[f->id()];
+      if ( jf>=0 ) // reached another junction, entering it by t
+       { JunctionGraph::Junction& J = g.juncs[jf];
+         int kf = t==J.s? 0 : t==J.s->nxt()? 1:2;
+         c.j[1]=jf; c.k[1]=(char)kf;
+         J.c[kf]=ci;
+         return;
+       }
+      g.cof[f->id()]=ci;
+      g.faces.push()=f;
+      c.n++;
+      SeDcdtSymEdge* x = !_man->is_constrained(t->nxt()->edg())? t->nxt() :
+                         !_man->is_constrained(t->nxn()->edg())? t->nxn() : 0;
+      if ( !x ) return; // dead end
+      float cl = travcl ( t, x );
+      if ( c.width<0 || cl<c.width ) c.width=cl;
+      GsPnt2 mx = midpoint ( x );
+      c.len += dist ( m, mx );
+      m = mx;
+      t = x->sym();
+    }
+ }
+
+int SeLct::compute_junction_graph ()
+ {
+   clear_junction_graph ();
+   if ( _dcdt_changed ) refine ();
+
+   _jg = new JunctionGraph;
+   _jg->ref ();
+   JunctionGraph& g = *_jg;
+   g.jof.size ( _mesh->idbound() );
+   g.jof.setall ( -1 );
+   g.cof.size ( _mesh->idbound() );
+   g.cof.setall ( -1 );
+
+   // junctions are the triangles with three unconstrained edges:
+   SeDcdtFace* f;
+   for ( f=_backface->nxt(); f!=_backface; f=f->nxt() )
+    { SeDcdtSymEdge* s = f->se();
+      if ( _man->is_constrained(s->edg()) || _man->is_constrained(s->nxt()->edg()) ||
+           _man->is_constrained(s->nxn()->edg()) ) continue;
+      g.jof[f->id()] = g.juncs.size();
+      JunctionGraph::Junction& J = g.juncs.push();
+      J.s = s;
+      for ( int k=0; k<3; k++ ) { J.c[k]=-1; J.m[k]=midpoint(jedge(s,k)); }
+    }
+
+   // each corridor is walked once, from the first of its junctions:
+   int j, k;
+   for ( j=0; j<g.juncs.size(); j++ )
+    for ( k=0; k<3; k++ )
+     if ( g.juncs[j].c[k]<0 ) _jgcorridor ( j, k );
+
+   g.juncs.compress();
+   g.corrs.compress();
+   g.faces.compress();
+   return g.juncs.size();
+ }
+
+void SeLct::clear_junction_graph ()
+ {
+   if ( _jg ) _jg->unref (); // query contexts may still reference it
+   _jg = 0;
+   _jgrestrict = false;
+ }
+
+// opens or improves the route state st located at p, with heuristic given by the distance to the goal
+void SeLct::_jgpush ( int st, float gc, int parent, int corr, const GsPnt2& p, const GsPnt2& goal )
+ {
+   JgState& n = _jgstates[st];
+   if ( n.stamp==_jgstamp && (n.closed || n.g<=gc) ) return;
+   n.stamp=_jgstamp; n.closed=false;
+   n.g=gc; n.parent=parent; n.corr=corr;
+   _jgheap.insert ( st, gc+dist(p,goal) );
+ }
+
+void SeLct::_jgallowcorridor ( int ci )
+ {
+   const JunctionGraph::Corridor& c = _jg->corrs[ci];
+   for ( int i=0; i<c.n; i++ ) _jgallow[_jg->faces[c.fst+i]->id()]=_jgstamp;
+ }
+
+// A* over the junction graph from the triangle of x1,y1 to the triangle of x2,y2. Junction states
+// store the edge used to enter the junction, so that the traversal to the next corridor is tested
+// with the same clearance test used by the triangle search, and are located at its midpoint. Returns 1 if a route was found, and
+// then only its triangles are allowed in the next search, 0 if the points are not covered by the
+// graph, and -1 if there is no route. As the graph contains every traversal the search can make,
+// and corridors are never adjacent to triangles outside the graph, no route means no path.
+int SeLct::_jgroute ( const SeFace* iniface, double x1, double y1, double x2, double y2, float radius )
+ {
+   SeBase *s1, *s2;
+   if ( locate_point(iniface,x1,y1,s1)!=TriangleFound ) return 0;
+   if ( locate_point(_locseed(x2,y2),x2,y2,s2)!=TriangleFound ) return 0;
+
+   JunctionGraph& g = *_jg;
+   int f1=s1->fac()->id(), f2=s2->fac()->id();
+   if ( f1>=g.jof.size() || f2>=g.jof.size() ) return 0;
+   int j1=g.jof[f1], c1=g.cof[f1];
+   int j2=g.jof[f2], c2=g.cof[f2];
+   if ( f1==f2 || (c1>=0 && c1==c2) ) return 0; // local query
+   bool in1 = j1>=0 || c1>=0;
+   bool in2 = j2>=0 || c2>=0;
+   if ( !in1 && !in2 ) return 0; // component without junctions
+   if ( !in1 || !in2 ) return -1; // only one point is in a component with junctions
+
+   // invalid endpoints are rejected here, instead of after the search reaches the goal triangle:
+   if ( !pt1circfree(this,s1,x1,y1,radius) || !pt2circfree(this,s2,x2,y2,radius) ) return -1;
+
+   // states are junction*4+k, k being the edge used to enter the junction or 3 at the start:
+   int ns = 4*g.juncs.size();
+   if ( _jgstates.size()<ns )
+    { int i = _jgstates.size();
+      _jgstates.size ( ns );
+      while ( i<ns ) _jgstates[i++].stamp=-1;
+    }
+   if ( _jgallow.size()<_mesh->idbound() )
+    { int i = _jgallow.size();
+      _jgallow.size ( _mesh->idbound() );
+      while ( i<_jgallow.size() ) _jgallow[i++]=-1;
+    }
+   _jgstamp++;
+
+   _jgheap.init ();
+   GsPnt2 p1 ( (float)x1, (float)y1 );
+   GsPnt2 p2 ( (float)x2, (float)y2 );
+   int e, k;
+   if ( j1>=0 )
+    { _jgpush ( j1*4+3, 0, -1, -1, p1, p2 ); }
+   else
+    { const JunctionGraph::Corridor& c = g.corrs[c1];
+      for ( e=0; e<2; e++ )
+       { if ( c.j[e]<0 ) continue;
+         const GsPnt2& m = g.juncs[c.j[e]].m[(int)c.k[e]];
+         _jgpush ( c.j[e]*4+c.k[e], dist(p1,m), -1, -1, m, p2 );
+       }
+    }
+
+   float d2 = 4.0f*radius*radius;
+   int last = -1;
+   while ( !_jgheap.empty() )
+    { int st = _jgheap.top();
+      _jgheap.remove();
+      if ( _jgstates[st].closed ) continue;
+      _jgstates[st].closed = true;
+      float gc = _jgstates[st].g;
+      int j=st/4, ke=st%4;
+      if ( j==j2 || (c2>=0 && (g.corrs[c2].j[0]==j || g.corrs[c2].j[1]==j)) ) { last=st; break; }
+      const JunctionGraph::Junction& J = g.juncs[j];
+      const GsPnt2& p = ke<3? J.m[ke] : p1;
+      for ( k=0; k<3; k++ )
+       { if ( k==ke ) continue;
+         const JunctionGraph::Corridor& c = g.corrs[J.c[k]];
+         if ( _pre_clearance )
+          { if ( ke<3 && travcl(jedge(J.s,ke),jedge(J.s,k))<d2 ) continue;
+            if ( c.width>=0 && c.width<d2 ) continue;
+          }
+         e = c.j[0]==j && c.k[0]==k? 1:0; // the other end
+         if ( c.j[e]<0 ) continue; // dead end
+         const GsPnt2& m = g.juncs[c.j[e]].m[(int)c.k[e]];
+         _jgpush ( c.j[e]*4+c.k[e], gc+dist(p,J.m[k])+c.len, st, J.c[k], m, p2 );
+       }
+    }
+
+   if ( last<0 ) { GS_TRACE1 ( "No route in the junction graph." ); return -1; }
+
+   // allow the triangles of the route, and the ones of the start and goal corridors:
+   _jgallow[f1]=_jgallow[f2]=_jgstamp;
+   if ( c1>=0 ) _jgallowcorridor ( c1 );
+   if ( c2>=0 ) _jgallowcorridor ( c2 );
+   for ( int st=last; st>=0; st=_jgstates[st].parent )
+    { _jgallow[g.juncs[st/4].s->fac()->id()]=_jgstamp;
+      if ( _jgstates[st].corr>=0 ) _jgallowcorridor ( _jgstates[st].corr );
+    }
+   return 1;
+ }
+
+//============================ End of File ===============================
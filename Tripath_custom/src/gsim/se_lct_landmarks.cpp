@@ -0,0 +1,341 @@
+/*=======================================================================
+   Copyright 2010 Marcelo Kallmann. All Rights Reserved.
+   This software is distributed for noncommercial use only, without
+   any warranties, and provided that all copies contain the full copyright
+   notice licence.txt located at the base folder of the distribution.
+  =======================================================================*/
+
+# include <math.h>
+# include <gsim/gs_heap.h>
+# include <gsim/gs_geo2.h>
+# include <gsim/se_lct.h>
+# include "se_triangulator_internal.h"
+
+//# define GS_USE_TRACE1 // landmark selection
+# include <gsim/gs_trace.h>
+
+//================================================================================
+//============================= landmarks ========================================
+//================================================================================
+
+// number of landmarks used by each query, the ones bounding best its start distance to the goal
+static const int LmActive = 4;
+
+// A visibility cone from the vertex being expanded, crossing edge e from its face, with e->vtx()
+// on the right side and e->nvtx() on the left one; r and l bound the cone on each side.
+struct LmCone { SeDcdtSymEdge* e; GsPnt2 r, l; };
+
+static void lmrelax ( GsHeap<int,float>& heap, GsArray<float>& d, int i, float c )
+ {
+   if ( d[i]>=0 && d[i]<=c ) return;
+   d[i] = c;
+   heap.insert ( i, c );
+ }
+
+// Labels with c the edges reachable from edge slot i in the graph of unconstrained edges, where
+// two edges of the same triangle are adjacent if the triangle can be traversed between them with
+// clearance d2 (the squared diameter). Returns the number of edges labelled, including i.
+int SeLct::_lmcomponent ( int i, int c, float d2, const GsArray<SeDcdtEdge*>& edges, GsArray<int>& comp )
+ {
+   const GsArray<int>& slot = _lm->slot;
+   GsArray<int> stack;
+   int labelled = 1;
+   comp[i] = c;
+   stack.push() = i;
+
+   while ( !stack.empty() )
+    { SeDcdtSymEdge* s = edges[stack.pop()]->se();
+      for ( int k=0; k<2; k++, s=s->sym() )
+       { if ( s->fac()==_backface ) continue;
+         SeDcdtSymEdge* t[2] = { s->nxt(), s->nxn() };
+         float cl[2] = { s->nxt()->edg()->cl(s->nxt()), s->edg()->cl(s) }; // bot and top traversals
+         for ( int j=0; j<2; j++ )
+          { if ( _man->is_constrained(t[j]->edg()) ) continue;
+            if ( _pre_clearance && cl[j]<d2 ) continue;
+            int tj = slot[t[j]->edg()->id()];
+            if ( comp[tj]>=0 ) continue;
+            comp[tj] = c;
+            labelled++;
+            stack.push() = tj;
+          }
+       }
+    }
+   return labelled;
+ }
+
+// Dijkstra over the vertices of the free space from vertex slot l, computing in d the lengths of
+// the shortest paths without clearance, which must be initialized with -1. As these paths only
+// bend at vertices of constrained edges, only those are expanded, relaxing all vertices visible
+// from them, which are found by propagating visibility cones across unconstrained edges.
+void SeLct::_lmgeodesic ( int l, const GsArray<SeDcdtVertex*>& verts, const GsArray<char>& corner, GsArray<float>& d )
+ {
+   GsHeap<int,float> heap;
+   GsArray<LmCone> cones;
+   const GsArray<int>& vslot = _lm->vslot;
+
+   d[l] = 0;
+   heap.insert ( l, 0 );
+
+   while ( !heap.empty() )
+    { int i = heap.top();
+      float c = heap.lowest_cost();
+      heap.remove();
+      if ( c>d[i] ) continue; // already settled with a lower cost
+      if ( i!=l && !corner[i] ) continue; // shortest paths do not bend here
+
+      const GsPnt2& p = verts[i]->p;
+      SeDcdtSymEdge *t, *ti;
+      t = ti = verts[i]->se();
+      do { SeDcdtSymEdge* e = t->nxt(); // opposite edge of the triangle of t
+           if ( t->fac()!=_backface && _lmfree(t) )
+            { lmrelax ( heap, d, vslot[e->vtx()->id()], c+dist(p,e->vtx()->p) );
+              lmrelax ( heap, d, vslot[e->nvtx()->id()], c+dist(p,e->nvtx()->p) );
+              if ( !_man->is_constrained(e->edg()) )
+               { LmCone& k = cones.push();
+                 k.e=e; k.r=e->vtx()->p; k.l=e->nvtx()->p;
+               }
+            }
+           t = t->rot();
+         } while ( t!=ti );
+
+      while ( !cones.empty() )
+       { LmCone k = cones.pop();
+         if ( k.e->sym()->fac()==_backface ) continue;
+         SeDcdtSymEdge* ac = k.e->sym()->nxt(); // the two other edges of the next triangle
+         SeDcdtSymEdge* cb = ac->nxt();
+         const GsPnt2& v = cb->vtx()->p;
+         double cr = gs_ccw ( p.x, p.y, k.r.x, k.r.y, v.x, v.y ); // >0 if v is left of the right side
+         double cl = gs_ccw ( p.x, p.y, v.x, v.y, k.l.x, k.l.y ); // >0 if v is right of the left side
+         if ( cr>=0 && cl>=0 ) lmrelax ( heap, d, vslot[cb->vtx()->id()], c+dist(p,v) );
+         if ( cr>0 && !_man->is_constrained(ac->edg()) ) // cones without width are not continued
+          { LmCone& n = cones.push();
+            n.e=ac; n.r=k.r; n.l=cl<0? k.l:v;
+          }
+         if ( cl>0 && !_man->is_constrained(cb->edg()) )
+          { LmCone& n = cones.push();
+            n.e=cb; n.r=cr<0? k.r:v; n.l=k.l;
+          }
+       }
+    }
+ }
+
+// Tests if the triangle of s is in the free space of the landmarks, which is the case if one
+// of its edges has a slot.
+bool SeLct::_lmfree ( SeBase* s )
+ {
+   for ( int k=0; k<3; k++, s=s->nxt() )
+    if ( _lmslot(s)>=0 ) return true;
+   return false;
+ }
+
+int SeLct::_lmslot ( SeBase* s )
+ {
+   int id = ((SeDcdtSymEdge*)s)->edg()->id();
+   return id<_lm->slot.size()? _lm->slot[id] : -1;
+ }
+
+int SeLct::compute_landmarks ( int nlandmarks, float radius )
+ {
+   clear_landmarks ();
+   if ( nlandmarks<=0 ) return 0;
+   if ( _dcdt_changed ) refine ();
+
+   _lm = new Landmarks;
+   _lm->ref ();
+   _lm->radius = radius;
+   _lm->n = 0;
+
+   // enumerate the unconstrained edges, which are the only ones crossed by channels:
+   GsArray<SeDcdtEdge*> edges;
+   _lm->slot.size ( _mesh->idbound() );
+   _lm->slot.setall ( -1 );
+   SeDcdtEdge *e, *ei;
+   e = ei = ((SeDcdtSymEdge*)_backface->se())->edg();
+   do { if ( !_man->is_constrained(e) ) { _lm->slot[e->id()]=edges.size(); edges.push()=e; }
+        e = e->nxt();
+      } while ( e!=ei );
+   if ( edges.empty() ) { clear_landmarks(); return 0; }
+
+   // the free space receiving the landmarks is the largest set of triangles connected by them:
+   GsArray<int> comp;
+   int i, l=0, c=0, maxlabelled=0, ne=edges.size();
+   comp.size ( ne );
+   comp.setall ( -1 );
+   for ( i=0; i<ne; i++ )
+    { if ( comp[i]>=0 ) continue;
+      int labelled = _lmcomponent ( i, i, 0, edges, comp );
+      if ( labelled>maxlabelled ) { maxlabelled=labelled; c=i; }
+    }
+   GsArray<SeDcdtEdge*> fedges;
+   for ( i=0; i<ne; i++ )
+    { if ( comp[i]==c ) { _lm->slot[edges[i]->id()]=fedges.size(); fedges.push()=edges[i]; }
+      else _lm->slot[edges[i]->id()]=-1;
+    }
+   edges.adopt ( fedges );
+   ne = edges.size();
+
+   // components of the edges with clearance for the radius, telling the unreachable goals:
+   float d2 = 4.0f*radius*radius;
+   _lm->comp.size ( ne );
+   _lm->comp.setall ( -1 );
+   for ( i=0; i<ne; i++ ) if ( _lm->comp[i]<0 ) _lmcomponent ( i, i, d2, edges, _lm->comp );
+
+   // the vertices of the triangles of the free space, marking the ones of constrained edges:
+   GsArray<SeDcdtVertex*> verts;
+   GsArray<char> corner;
+   _lm->vslot.size ( _mesh->idbound() );
+   _lm->vslot.setall ( -1 );
+   for ( i=0; i<ne; i++ )
+    { SeDcdtSymEdge* s = edges[i]->se();
+      for ( int k=0; k<6; k++, s=k==3? s->nxt()->sym():s->nxt() ) // both triangles
+       { SeDcdtVertex* v = s->vtx();
+         if ( _lm->vslot[v->id()]>=0 ) continue;
+         _lm->vslot[v->id()] = verts.size();
+         verts.push() = v;
+         char& cn = corner.push();
+         cn = 0;
+         SeDcdtSymEdge *t, *ti;
+         t = ti = v->se();
+         do { if ( _man->is_constrained(t->edg()) ) cn=1;
+              t = t->rot();
+            } while ( t!=ti );
+       }
+    }
+
+   // farthest-point selection: each landmark is the vertex maximizing the minimum distance
+   // to the previous landmarks, starting from the vertex farthest from one in the free space:
+   GsArray<float> d, mind;
+   int nv = verts.size();
+   d.size ( nv );
+   mind.size ( nv );
+   mind.setall ( -1.0f );
+   _lmgeodesic ( 0, verts, corner, mind );
+   _lm->dist.size ( nv*nlandmarks );
+   while ( _lm->n<nlandmarks )
+    { for ( l=-1, i=0; i<nv; i++ )
+       { if ( mind[i]>0 && (l<0 || mind[i]>mind[l]) ) l=i;
+       }
+      if ( l<0 ) break; // no more reachable vertices
+      GS_TRACE1 ( "Landmark "<<_lm->n<<": vertex slot "<<l<<" at "<<mind[l] );
+      d.setall ( -1.0f );
+      _lmgeodesic ( l, verts, corner, d );
+      for ( i=0; i<nv; i++ ) _lm->dist[i*nlandmarks+_lm->n]=d[i];
+      if ( _lm->n==0 ) mind=d; // the first search was only used to find a far vertex
+      else for ( i=0; i<nv; i++ ) if ( d[i]>=0 && d[i]<mind[i] ) mind[i]=d[i];
+      _lm->n++;
+    }
+
+   // compact the distance table if fewer landmarks were found:
+   if ( _lm->n<nlandmarks )
+    { for ( i=0; i<nv; i++ )
+       for ( l=0; l<_lm->n; l++ ) _lm->dist[i*_lm->n+l]=_lm->dist[i*nlandmarks+l];
+      _lm->dist.size ( nv*_lm->n );
+    }
+   _lm->dist.compress();
+   return _lm->n;
+ }
+
+void SeLct::clear_landmarks ()
+ {
+   if ( _lm ) _lm->unref (); // query contexts may still reference it
+   _lm = 0;
+   _lmgoal.size ( 0 );
+ }
+
+// Bounds in b the distance of point (x,y) in triangle s to each landmark, from the distances of
+// the vertices of the triangle; both bounds are -1 if no vertex is reachable from the landmark.
+void SeLct::_lmbounds ( SeBase* s, double x, double y, float* b )
+ {
+   int n = _lm->n;
+   for ( int l=0; l<2*n; l++ ) b[l]=-1.0f;
+   GsPnt2 p ( (float)x, (float)y );
+   for ( int k=0; k<3; k++, s=s->nxt() )
+    { SeDcdtVertex* v = ((SeDcdtSymEdge*)s)->vtx();
+      float r = dist ( p, v->p );
+      const float* d = &_lm->dist[_lm->vslot[v->id()]*n];
+      for ( int l=0; l<n; l++ )
+       { if ( d[l]<0 ) continue;
+         float& lo = b[2*l];
+         float& hi = b[2*l+1];
+         if ( hi<0 || d[l]-r>lo ) lo=d[l]-r;
+         if ( hi<0 || d[l]+r<hi ) hi=d[l]+r;
+       }
+    }
+ }
+
+// Sets _lmgoal with the components of the goal edges when the radius allows them to be used,
+// followed by the index and goal bounds of the active landmarks, which are the ones giving the
+// best lower bounds between the start point (xs,ys) in triangle s and the goal (x,y). Leaves
+// _lmgoal empty when the landmarks cannot be used in the current query.
+void SeLct::_lmsetgoal ( SeBase* s, double xs, double ys, double x, double y, float radius )
+ {
+   _lmgoal.size ( 0 );
+   if ( !_lm || _goals.pts.size() ) return;
+   SeBase* sg;
+   if ( locate_point(_locseed(x,y),x,y,sg)==NotFound ) return;
+   if ( !_lmfree(sg) ) return;
+
+   int k, l, n = _lm->n;
+   GsArray<float> gb, sb;
+   gb.size ( 2*n );
+   _lmbounds ( sg, x, y, &gb[0] );
+   sb.size ( 2*n );
+   if ( _lmfree(s) ) _lmbounds ( s, xs, ys, &sb[0] ); else sb.setall ( -1.0f );
+
+   _lmgoal.size ( 3 );
+   for ( k=0; k<3; k++, sg=sg->nxt() )
+    { int i = _lmslot ( sg );
+      _lmgoal[k] = i>=0 && radius>=_lm->radius? (float)_lm->comp[i] : -1.0f;
+    }
+
+   // keep the landmarks with the best start bounds, sorted by insertion:
+   GsArray<float> score;
+   for ( l=0; l<n; l++ )
+    { if ( gb[2*l+1]<0 ) continue;
+      float c = sb[2*l+1]<0? 0 : GS_MAX ( gb[2*l]-sb[2*l+1], sb[2*l]-gb[2*l+1] );
+      for ( k=score.size(); k>0 && score[k-1]<c; k-- );
+      if ( k>=LmActive ) continue;
+      score.insert ( k ) = c;
+      float* g = &_lmgoal.insert ( 3+3*k, 3 );
+      g[0] = (float)l;
+      g[1] = gb[2*l];
+      g[2] = gb[2*l+1];
+      if ( score.size()>LmActive ) { score.pop(); _lmgoal.size(_lmgoal.size()-3); }
+    }
+ }
+
+float SeLct::_heuristic ( SeBase* s, double x, double y )
+ {
+   float h = (float)sqrt(gs_dist2(x,y,_xg,_yg));
+   if ( _lmgoal.empty() ) return h;
+
+   int i = _lmslot ( s );
+   if ( i<0 ) return _man->is_constrained(((SeDcdtSymEdge*)s)->edg())? h : -1.0f;
+
+   const float* gc = &_lmgoal[0];
+   if ( gc[0]>=0 || gc[1]>=0 || gc[2]>=0 )
+    { float c = (float)_lm->comp[i];
+      if ( c!=gc[0] && c!=gc[1] && c!=gc[2] ) return -1.0f;
+    }
+
+   int n = _lm->n;
+   SeDcdtVertex* a = ((SeDcdtSymEdge*)s)->vtx();
+   SeDcdtVertex* b = ((SeDcdtSymEdge*)s)->nvtx();
+   const float* da = &_lm->dist[_lm->vslot[a->id()]*n];
+   const float* db = &_lm->dist[_lm->vslot[b->id()]*n];
+   float ra = (float)sqrt(gs_dist2(x,y,a->p.x,a->p.y));
+   float rb = (float)sqrt(gs_dist2(x,y,b->p.x,b->p.y));
+   for ( int k=3; k<_lmgoal.size(); k+=3 )
+    { int l = (int)_lmgoal[k];
+      if ( da[l]<0 || db[l]<0 ) continue; // no information from this landmark
+      float lo = GS_MAX ( da[l]-ra, db[l]-rb );
+      float hi = GS_MIN ( da[l]+ra, db[l]+rb );
+      float lh = _lmgoal[k+1]-hi;
+      if ( lh>h ) h=lh;
+      lh = lo-_lmgoal[k+2];
+      if ( lh>h ) h=lh;
+    }
+   return h;
+ }
+
+//============================ End of File ===============================
@@ -0,0 +1,96 @@
+/*=======================================================================
+   Copyright 2010 Marcelo Kallmann. All Rights Reserved.
+   This software is distributed for noncommercial use only, without
+   any warranties, and provided that all copies contain the full copyright
+   notice licence.txt located at the base folder of the distribution.
+  =======================================================================*/
+
+# include <thread>
+# include <gsim/se_lct_query.h>
+
+//================================================================================
+//============================= parallel passes ==================================
+//================================================================================
+
+// number of threads of a pass over n elements, as starting a thread costs more than testing few elements
+int SeLct::_passthreads ( int n ) const
+ {
+   int nt = _refthreads>0? _refthreads : (int)std::thread::hardware_concurrency();
+   if ( nt>n/4096 ) nt=n/4096;
+   return nt<1? 1:nt;
+ }
+
+// collects in out the refinements needed in the given edges, testing the other side of an edge
+// only when the first one does not need refinement
+void SeLct::_scan_refinements ( SeDcdtEdge* const* edges, int n, RefinementType type, GsArray<SeDcdtSymEdge*>* out )
+ {
+   SeDcdtSymEdge *s, *sub, *dv;
+   for ( int i=0; i<n; i++ )
+    { s = edges[i]->se();
+      sub = _needs_refinement(s,type,dv);
+      if ( !sub )
+       { s = s->sym();
+         sub = _needs_refinement(s,type,dv);
+       }
+      if ( sub ) { out->push()=s; out->push()=sub; out->push()=dv; }
+    }
+ }
+
+void SeLct::_clear_faces ( SeDcdtFace* const* faces, int n )
+ {
+   for ( int i=0; i<n; i++ ) _face_clearance ( faces[i] );
+ }
+
+// Collects in _earray the refinements needed in all edges. The tests keep the blocking
+// constraint found in the object, so each thread tests its part of the edges with its
+// own context, and the parts are appended in the order of a single-threaded scan.
+void SeLct::_collect_all_refinements ( RefinementType type )
+ {
+   GsArray<SeDcdtEdge*> edges;
+   SeDcdtEdge *e, *ei;
+   e = ei = ((SeDcdtSymEdge*)_backface->se())->edg();
+   do { edges.push()=e; e=e->nxt(); } while ( e!=ei );
+
+   int i, n=edges.size(), nt=_passthreads(n);
+   if ( nt==1 ) { _scan_refinements(&edges[0],n,type,&_earray); return; }
+
+   GsArray<SeDcdtSymEdge*>* out = new GsArray<SeDcdtSymEdge*>[nt];
+   SeLctQuery** ctx = new SeLctQuery*[nt];
+   std::thread* t = new std::thread[nt];
+   for ( i=0; i<nt; i++ ) ctx[i] = new SeLctQuery ( this, false ); // contexts are created before any thread starts
+   for ( i=0; i<nt; i++ )
+    { int beg=int((long long)n*i/nt), end=int((long long)n*(i+1)/nt);
+      t[i] = std::thread ( &SeLct::_scan_refinements, ctx[i], &edges[beg], end-beg, type, &out[i] );
+    }
+   for ( i=0; i<nt; i++ )
+    { t[i].join();
+      for ( int k=0; k<out[i].size(); k++ ) _earray.push()=out[i][k];
+      delete ctx[i];
+    }
+   delete[] t;
+   delete[] ctx;
+   delete[] out;
+ }
+
+// Precomputes the clearances of all faces. A face only writes the clearances of its own side
+// of its edges, and the clearance tests keep no state, so the threads share this object.
+void SeLct::compute_clearance ()
+ {
+   GsArray<SeDcdtFace*> faces;
+   SeDcdtFace* f;
+   for ( f=_backface->nxt(); f!=_backface; f=f->nxt() ) faces.push()=f;
+   if ( faces.empty() ) return;
+
+   int i, n=faces.size(), nt=_passthreads(n);
+   if ( nt==1 ) { _clear_faces(&faces[0],n); return; }
+
+   std::thread* t = new std::thread[nt];
+   for ( i=0; i<nt; i++ )
+    { int beg=int((long long)n*i/nt), end=int((long long)n*(i+1)/nt);
+      t[i] = std::thread ( &SeLct::_clear_faces, this, &faces[beg], end-beg );
+    }
+   for ( i=0; i<nt; i++ ) t[i].join();
+   delete[] t;
+ }
+
+//============================ End of File ===============================
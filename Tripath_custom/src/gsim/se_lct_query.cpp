@@ -0,0 +1,45 @@
+/*=======================================================================
+   Copyright 2010 Marcelo Kallmann. All Rights Reserved.
+   This software is distributed for noncommercial use only, without
+   any warranties, and provided that all copies contain the full copyright
+   notice licence.txt located at the base folder of the distribution. 
+  =======================================================================*/
+
+# include <gsim/se_lct_query.h>
+
+//=============================== SeLctQuery ==================================
+
+SeLctQuery::SeLctQuery ( SeLct* lct, bool refine )
+           :SeLct ( lct->mesh(), lct->man(), lct->epsilon() )
+ {
+   if ( refine ) lct->refine (); // refinement and clearances are computed before sharing the mesh
+
+   _mode = lct->_mode;
+   _epsilonedg = lct->_epsilonedg;
+   _backface = lct->_backface;
+   _cur_search_face = lct->_cur_search_face;
+   _xmin = lct->_xmin; _xmax = lct->_xmax;
+   _ymin = lct->_ymin; _ymax = lct->_ymax;
+   _radius = lct->_radius;
+   _auto_refinement = lct->_auto_refinement;
+   _pre_clearance = lct->_pre_clearance;
+   _lm = lct->_lm; // shared with lct, and kept while the context exists
+   if ( _lm ) _lm->ref ();
+   _jg = lct->_jg;
+   if ( _jg ) _jg->ref ();
+   _frz = lct->_frz;
+   if ( _frz ) _frz->ref ();
+   _bidir = lct->_bidir;
+   _lg->unref (); // the point location grid of lct is used instead
+   _lg = lct->_lg;
+   _lg->ref ();
+   _dcdt_changed = false;
+   _marker = &_qmarker;
+ }
+
+SeLctQuery::~SeLctQuery ()
+ {
+   // the shared structures are unreferenced by the destructor of SeLct
+ }
+
+//============================ End of File ===============================
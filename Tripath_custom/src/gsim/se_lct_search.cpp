@@ -23,6 +23,20 @@
 //========================== search path tree ====================================
 //================================================================================
 
+// cost point used by multi-goal searches, which cannot be directed to a goal:
+// the point of edge (x1,y1),(x2,y2) closest to (xn,yn), kept r away from the edge vertices
+static void closestcostpoint ( double xn, double yn, double x1, double y1, double x2, double y2, double& x, double& y, double r )
+ {
+   double t;
+   double len = sqrt(gs_dist2(x1,y1,x2,y2));
+   gs_point_segment_dist2 ( xn, yn, x1, y1, x2, y2, t );
+   double tr = len>0? r/len : 0.5;
+   if ( tr>0.5 ) tr=0.5;
+   if ( t<tr ) t=tr; else if ( t>1.0-tr ) t=1.0-tr;
+   x = x1+t*(x2-x1);
+   y = y1+t*(y2-y1);
+ }
+
 // nen/nex are the entrance/exit edges of the node being expanded, which is already in the search tree
 // en/ex are the entrance/exit edge of the current traversal being evaluated for expansion
 // (p1,p2) are en coordinates
@@ -32,8 +46,12 @@ bool SeLct::_canpass ( SeDcdtSymEdge* nen, SeDcdtSymEdge* nex, SeDcdtSymEdge* en
    // check if can traverse en/ex traversal:
    if ( _man->is_constrained(ex->edg()) ) return false;
 
-   // test if next triangle being tested has been already visited:
-   if ( _mesh->marked(en->fac()) ) return false;
+   // searches restricted to a route of the junction graph only traverse its triangles:
+   if ( _jgrestrict && _jgallow[en->fac()->id()]!=_jgstamp ) return false;
+
+   // test if next triangle being tested has been already visited
+   // (multi-goal searches instead do not cross an edge twice in the same direction):
+   if ( _goals.pts.size()? _crossed(ex) : _visited(en->fac()) ) return false;
 
    if ( en->nxt()==ex ) // bot
     { 
@@ -74,17 +92,29 @@ void SeLct::_trytoadd ( SeDcdtSymEdge* en, SeDcdtSymEdge* ex, int mi, const GsPn
    PathNode& n = _ptree->nodes[mi];
    if ( !_canpass ( (SeDcdtSymEdge*)n.en, (SeDcdtSymEdge*)n.ex, en, ex, p1, p2, p3, _ptree->radius, _ptree->diam2 ) ) return;
 
+   // multi-goal channels must stay simple for the funnel, so they cannot enter a triangle twice:
+   if ( _goals.pts.size() && _onchannel(mi,ex->sym()->fac()) ) { _goals.pruned++; return; }
+
    // ok it is passable, compute cost:
    double x, y;
 
-   if ( en->nxt()==ex )
+   if ( _goals.pts.size() )
+    { if ( en->nxt()==ex )
+       closestcostpoint ( n.x, n.y, p2.x, p2.y, p3.x, p3.y, x, y, _ptree->radius ); // bot
+      else
+       closestcostpoint ( n.x, n.y, p3.x, p3.y, p1.x, p1.y, x, y, _ptree->radius ); // top
+    }
+   else if ( en->nxt()==ex )
     _getcostpoint ( &n, n.x, n.y, p2.x, p2.y, p3.x, p3.y, x, y, _ptree->radius ); // bot
    else
     _getcostpoint ( &n, n.x, n.y, p3.x, p3.y, p1.x, p1.y, x, y, _ptree->radius ); // top
    // insert:
+   float h = _goals.pts.size()? 0:_heuristic(ex,x,y); // A* heuristic
+   if ( h<0 ) return; // the landmarks show that the goal cannot be reached from ex
    # define PTDIST(a,b,c,d) float(sqrt(gs_dist2(a,b,c,d)))
-   _ptree->add_child ( mi, en, ex, n.ncost+PTDIST(n.x,n.y,x,y), PTDIST(x,y,_xg,_yg), x,y ); // A* heuristic
+   _ptree->add_child ( mi, en, ex, n.ncost+PTDIST(n.x,n.y,x,y), h, x,y );
    # undef PTDIST
+   if ( _goals.pts.size() ) _addbound ( _ptree->nodes.size()-1 );
  }
 
 # define ExpansionNotFinished  -1
@@ -100,6 +130,7 @@ int SeLct::_expand_lowest_cost_leaf ()
    GS_TRACE2 ( "Expanding leaf: "<<min_i );
 
    if ( min_i<0 ) return ExpansionBlocked; // no more leafs: path could not be found!
+   _expanded[_bi && _bi->backward? 1:0]++;
 
    // attention: array references may be invalidated due array reallocation during insertion
    SeDcdtSymEdge* s = (SeDcdtSymEdge*) _ptree->nodes[min_i].ex->sym();
@@ -110,8 +141,17 @@ int SeLct::_expand_lowest_cost_leaf ()
    const GsPnt2& p3 = sp->vtx()->p;
    float d2 = _ptree->diam2;
 
+   // in multi-goal searches each edge direction is expanded only once, goals are settled
+   // when no leaf can lead to a shorter path, and the expansion continues until no goal remains open:
+   if ( _goals.pts.size()>0 )
+    { if ( _finish_goals(_goalbound()) ) return min_i; // all goals settled
+      _goals.leaf[min_i] = 0;
+      if ( _crossed(_ptree->nodes[min_i].ex) ) return ExpansionNotFinished;
+      _cross ( _ptree->nodes[min_i].ex );
+      _reach_goals ( min_i, s );
+    }
    // test if next triangle contains goal point:
-   if ( gs_in_triangle(p1.x,p1.y,p2.x,p2.y,p3.x,p3.y,_xg,_yg) ) // reached goal triangle !
+   else if ( gs_in_triangle(p1.x,p1.y,p2.x,p2.y,p3.x,p3.y,_xg,_yg) ) // reached goal triangle !
     { GS_TRACE1 ( "Goal triangle reached..." );
       double r = _ptree->radius;
       if ( !pt2circfree(this,s,_xg,_yg,r) ) // we do not know if the goal location is valid, so test it now
@@ -147,13 +187,133 @@ int SeLct::_expand_lowest_cost_leaf ()
    _trytoadd ( s, sn, min_i, p1, p2, p3 ); // bot
    _trytoadd ( s, sp, min_i, p1, p2, p3 ); // top
 
-   if ( _ptree->nodes.size()>nsize ) _mesh->mark ( s->fac() ); // only mark traversed faces
+   if ( _ptree->nodes.size()>nsize ) _visit ( s->fac() ); // only mark traversed faces
 
    if (_searchcb) _searchcb(_sudata);
 
    return ExpansionNotFinished; // continue the expansion
  }
 
+// the edge of s was crossed in the direction of s in the current multi-goal search;
+// edge nodeids (or edge ids with a marker) index the crossings of the search, which are
+// validated with the edge pointer so that they never need to be reset
+bool SeLct::_crossed ( SeBase* s )
+ {
+   SeDcdtEdge* e = ((SeDcdtSymEdge*)s)->edg();
+   int i = _crossing ( e );
+   if ( i<0 || i>=_goals.crossed.size() || _goals.crossed[i].e!=e ) return false;
+   return _goals.crossed[i].dirs & (s==e->se()? 1:2)? true:false;
+ }
+
+// Keeps the lower bound of the paths through the new node ni: the distance from the start to the
+// edge it crosses, as a path through ni crosses it, and not less than the bound of its parent.
+// The costs of the nodes are not bounds, as they are measured through points of the edges.
+void SeLct::_addbound ( int ni )
+ {
+   const PathNode& n = _ptree->nodes[ni];
+   const GsPnt2& p1 = ((SeDcdtSymEdge*)n.ex)->vtx()->p;
+   const GsPnt2& p2 = ((SeDcdtSymEdge*)n.ex)->nvtx()->p;
+   double t;
+   float lb = float(sqrt(gs_point_segment_dist2(_xi,_yi,p1.x,p1.y,p2.x,p2.y,t)));
+   if ( n.parent>=0 && _goals.lb[n.parent]>lb ) lb=_goals.lb[n.parent];
+   _goals.lb.push() = lb;
+   _goals.leaf.push() = 1;
+   _goals.bounds.insert ( ni, lb );
+ }
+
+// lowest bound of the paths that can still be found, i.e. through the leafs not yet expanded
+float SeLct::_goalbound ()
+ {
+   while ( !_goals.bounds.empty() && !_goals.leaf[_goals.bounds.top()] ) _goals.bounds.remove();
+   return _goals.bounds.empty()? -1.0f : _goals.bounds.lowest_cost();
+ }
+
+// face f is the initial face or is entered by node mi or by one of its ancestors
+bool SeLct::_onchannel ( int mi, SeFace* f )
+ {
+   if ( f==_fi ) return true;
+   for ( int n=mi; n>=0; n=_ptree->nodes[n].parent )
+    { if ( _ptree->nodes[n].ex->sym()->fac()==f ) return true;
+    }
+   return false;
+ }
+
+void SeLct::_cross ( SeBase* s )
+ {
+   SeDcdtEdge* e = ((SeDcdtSymEdge*)s)->edg();
+   int& i = _crossing ( e );
+   if ( i<0 || i>=_goals.crossed.size() || _goals.crossed[i].e!=e )
+    { i = _goals.crossed.size();
+      _goals.crossed.push().e = e;
+      _goals.crossed[i].dirs = 0;
+    }
+   _goals.crossed[i].dirs |= s==e->se()? 1:2;
+ }
+
+// computes the funnel paths of the arrivals at the open goals inside the triangle of s, which is
+// entered by node mi; the shortest path of each goal is kept until _finish_goals() settles it
+void SeLct::_reach_goals ( int mi, SeDcdtSymEdge* s )
+ {
+   SeDcdtSymEdge* sn = s->nxt();
+   SeDcdtSymEdge* sp = sn->nxt();
+   const GsPnt2& p1 = s->vtx()->p;
+   const GsPnt2& p2 = sn->vtx()->p;
+   const GsPnt2& p3 = sp->vtx()->p;
+   float r = _ptree->radius;
+   float d2 = _ptree->diam2;
+
+   for ( int i=0; i<_goals.pts.size(); i++ )
+    { if ( _goals.st[i]!='o' ) continue;
+      const GsPnt2& g = _goals.pts[i];
+      if ( !gs_in_triangle(p1.x,p1.y,p2.x,p2.y,p3.x,p3.y,g.x,g.y) ) continue;
+
+      GS_TRACE1 ( "Goal "<<i<<" triangle reached..." );
+      _xg=g.x; _yg=g.y; // the arrival tests and the funnel use the current goal
+      if ( !pt2circfree(this,s,_xg,_yg,r) )
+       { GS_TRACE1 ( "Goal location is invalid." );
+         _goals.st[i]='u'; _goals.open--;
+         continue;
+       }
+      _analyze_arrival ( s, 3, r, d2, (SeDcdtSymEdge*)_ptree->nodes[mi].en, (SeDcdtSymEdge*)_ptree->nodes[mi].ex );
+      if ( _ent[3].type==EntBlocked )
+       { if ( (sn->edg()->is_constrained()||dist2(p2,p3)<d2) &&
+              (sp->edg()->is_constrained()||dist2(p3,p1)<d2) ) 
+          { GS_TRACE1 ( "Arrival blocked from all possible entries." );
+            _goals.st[i]='u'; _goals.open--;
+          }
+         continue; // otherwise the goal may still be reached from another entrance
+       }
+
+      // build the channel up to this goal and its funnel path:
+      _finalsearchnode = mi;
+      _channel.size(0);
+      int n = mi;
+      do { _channel.push() = _ptree->nodes[n].ex;
+           n = _ptree->nodes[n].parent; 
+         } while ( n!=-1 );
+      _channel.revert();
+      _path_result = GlobalPath;
+
+      float len = funnel_path_length ( r );
+      if ( _goals.lens[i]<0 || len<_goals.lens[i] )
+       { _goals.lens[i] = len;
+         if ( _goals.paths ) _fpathmake ( _fpath, _goals.paths[i], r, _goals.dang );
+       }
+    }
+ }
+
+// settles the open goals with paths not longer than cost, as no cheaper node
+// can reach them anymore (cost<0 settles all goals with paths)
+bool SeLct::_finish_goals ( float cost )
+ {
+   for ( int i=0; i<_goals.pts.size(); i++ )
+    { if ( _goals.st[i]!='o' || _goals.lens[i]<0 ) continue;
+      if ( cost>=0 && _goals.lens[i]>cost ) continue;
+      _goals.st[i]='r'; _goals.open--;
+    }
+   return _goals.open==0;
+ }
+
 void SeLct::_ptreeaddent ( SeDcdtSymEdge* s, bool top, bool edge )
  {
    const GsPnt2& p1 = s->vtx()->p;
@@ -161,13 +321,18 @@ void SeLct::_ptreeaddent ( SeDcdtSymEdge* s, bool top, bool edge )
    double x, y;
    if ( edge )
     { x=_xi; y=_yi; }
+   else if ( _goals.pts.size() )
+    { closestcostpoint ( _xi, _yi, p1.x, p1.y, p2.x, p2.y, x, y, _ptree->radius ); }
    else
     { _getcostpoint ( 0, _xi, _yi, p1.x, p1.y, p2.x, p2.y, x, y, _ptree->radius ); }
 
    // insert:
+   float h = _goals.pts.size()? 0:_heuristic(s,x,y);
+   if ( h<0 ) return; // goal not reachable from s
    # define PTDIST(a,b,c,d) (float)sqrt(gs_dist2(a,b,c,d))
-   _ptree->add_child ( -1, top? s->nxt():s->nxn(), s, PTDIST(_xi,_yi,x,y), PTDIST(x,y,_xg,_yg), x, y );
+   _ptree->add_child ( -1, top? s->nxt():s->nxn(), s, PTDIST(_xi,_yi,x,y), h, x, y );
    # undef PTDIST
+   if ( _goals.pts.size() ) _addbound ( _ptree->nodes.size()-1 );
  }
 
 //================================================================================
@@ -179,6 +344,12 @@ bool SeLct::_search_channel ( double x1, double y1, double x2, double y2, float
  {
    GS_TRACE1 ( "Starting Search Path..." );
 
+   if ( _bidir )
+    { int r = _bisearch_channel ( x1, y1, x2, y2, radius, iniface );
+      if ( r>=0 ) return r>0;
+      GS_TRACE1 ( "Bidirectional search not conclusive, searching forward..." );
+    }
+
    if ( !_ptree ) _ptree = new PathTree;
    _clear_path(); // clear data from previous query and set _path_result to NoPath
 
@@ -239,20 +410,25 @@ bool SeLct::_search_channel ( double x1, double y1, double x2, double y2, float
    GS_TRACE1 ( "Entrance 2: "<<(_ent[2].type==EntBlocked?"blocked":_ent[2].type==EntTrivial?"trivial":"not trivial") );
 
    GS_TRACE1 ( "Initializing A* search..." );
-   _mesh->begin_marking ();
+   _lmsetgoal ( s, x1, y1, x2, y2, radius );
+   _begin_marking ();
    _ptree->init ( radius );
    if ( _ent[0].type!=EntBlocked ) _ptreeaddent ( _ent[0].s, _ent[0].top, res==EdgeFound? true:false );
    if ( _ent[1].type!=EntBlocked ) _ptreeaddent ( _ent[1].s, _ent[1].top, false );
    if ( _ent[2].type!=EntBlocked ) _ptreeaddent ( _ent[2].s, _ent[2].top, false );
 
+   // the frozen mesh is used with precomputed clearances, and without route restrictions:
+   bool frozen = _frz && _pre_clearance && !_jgrestrict;
+   if ( frozen ) _frzbegin ();
+
    if (_searchcb) _searchcb(_sudata);
 
    GS_TRACE1 ( "Expanding leafs..." );
    int found = ExpansionNotFinished;
    while ( found==ExpansionNotFinished )
-    found = _expand_lowest_cost_leaf();
+    found = frozen? _frz_expand_lowest_cost_leaf() : _expand_lowest_cost_leaf();
 
-   _mesh->end_marking ();
+   _end_marking ();
 
    if ( found==ExpansionBlocked )
     { GS_TRACE1 ( "Points are not connectable!" );
@@ -275,6 +451,103 @@ bool SeLct::_search_channel ( double x1, double y1, double x2, double y2, float
    return true;
  }
 
+/* - Tests if the channel of the last global path, found with a smaller radius, is also passable
+     with the given radius, repeating along it the departure, traversal and arrival tests of the
+     search. If so the entrances and the arrival are analyzed for the radius and the funnel can be
+     run over the channel, which may however be longer than the one a new search would find. */
+bool SeLct::_reuse_channel ( float radius )
+ {
+   if ( _path_result!=GlobalPath || _channel.empty() ) return false;
+
+   SeBase *s;
+   if ( locate_point(_fi,_xi,_yi,s)==NotFound ) return false;
+   if ( !pt1circfree(this,s,_xi,_yi,radius) ) return false;
+   _analyze_entrances ( s, _xi, _yi, radius );
+   int k = _channel[0]==_ent[0].s? 0 : _channel[0]==_ent[1].s? 1 : _channel[0]==_ent[2].s? 2:-1;
+   if ( k<0 || _ent[k].type==EntBlocked ) return false;
+
+   // traversals of the channel, from the departure node as added by _ptreeaddent():
+   float d2 = 4.0f*radius*radius;
+   SeDcdtSymEdge* nex = (SeDcdtSymEdge*)_channel[0];
+   SeDcdtSymEdge* nen = _ent[k].top? nex->nxt():nex->nxn();
+   bool pass = true;
+   _begin_marking (); // the channel traverses each triangle once
+   for ( int i=1; i<_channel.size() && pass; i++ )
+    { SeDcdtSymEdge* en = nex->sym();
+      SeDcdtSymEdge* ex = (SeDcdtSymEdge*)_channel[i];
+      const GsPnt2& p1 = en->vtx()->p;
+      const GsPnt2& p2 = en->nxt()->vtx()->p;
+      const GsPnt2& p3 = en->nxn()->vtx()->p;
+      pass = _canpass ( nen, nex, en, ex, p1, p2, p3, radius, d2 );
+      nen=en; nex=ex;
+    }
+
+   s = nex->sym();
+   if ( pass ) pass = pt2circfree ( this, s, _xg, _yg, radius );
+   if ( pass ) _analyze_arrival ( s, 3, radius, d2, nen, nex );
+   _end_marking ();
+   return pass && _ent[3].type!=EntBlocked;
+ }
+
+/* - Uniform-cost version of _search_channel() expanding until all open goals are settled.
+     Goals in the initial triangle are marked as local, to be solved with single queries. */
+void SeLct::_search_channels ( double x1, double y1, float radius, const SeFace* iniface )
+ {
+   GS_TRACE1 ( "Starting Multi-Goal Search..." );
+
+   if ( !_ptree ) _ptree = new PathTree;
+   _clear_path();
+
+   _channel.size(0);
+   _xi=x1; _yi=y1;
+
+   if ( !iniface ) return;
+
+   SeBase *s;
+   LocateResult res=locate_point ( iniface, x1, y1, s );
+   if ( res==NotFound )
+    { GS_TRACE1 ( "Could not locate first point!" );
+      return;
+    }
+   _fi = s->fac(); // save initial face
+   if ( !pt1circfree(this,s,x1,y1,radius) ) return;
+
+   for ( int i=0; i<_goals.pts.size(); i++ )
+    { const GsPnt2& g = _goals.pts[i];
+      if ( _goals.st[i]=='o' && _man->in_triangle(s->vtx(),s->nxt()->vtx(),s->nxn()->vtx(),g.x,g.y) )
+       { _goals.st[i]='l'; _goals.open--; }
+    }
+   if ( _goals.open==0 ) return;
+
+   _analyze_entrances ( s, _xi, _yi, radius );
+
+   _begin_marking (); // still needed by the arrival analysis
+   _ptree->init ( radius );
+   _goals.crossed.size ( 0 );
+   _goals.lb.size ( 0 );
+   _goals.leaf.size ( 0 );
+   _goals.bounds.init ();
+   if ( _marker && _goals.ids.size()<_mesh->idbound() ) // edges of the shared mesh are not written
+    { int i = _goals.ids.size();
+      _goals.ids.size ( _mesh->idbound() );
+      while ( i<_goals.ids.size() ) _goals.ids[i++]=-1;
+    }
+   if ( _ent[0].type!=EntBlocked ) _ptreeaddent ( _ent[0].s, _ent[0].top, res==EdgeFound? true:false );
+   if ( _ent[1].type!=EntBlocked ) _ptreeaddent ( _ent[1].s, _ent[1].top, false );
+   if ( _ent[2].type!=EntBlocked ) _ptreeaddent ( _ent[2].s, _ent[2].top, false );
+
+   if (_searchcb) _searchcb(_sudata);
+
+   int found = ExpansionNotFinished;
+   while ( found==ExpansionNotFinished )
+    found = _expand_lowest_cost_leaf();
+
+   if ( found==ExpansionBlocked ) _finish_goals ( -1 ); // settle pending arrivals
+   _end_marking ();
+
+   GS_TRACE1 ( "Goals not reached: "<<_goals.open );
+ }
+
 void SeLct::get_search_nodes ( GsArray<SeBase*>& e )
  {
    e.size ( 0 );
@@ -0,0 +1,260 @@
+/*=======================================================================
+   Copyright 2010 Marcelo Kallmann. All Rights Reserved.
+   This software is distributed for noncommercial use only, without
+   any warranties, and provided that all copies contain the full copyright
+   notice licence.txt located at the base folder of the distribution. 
+  =======================================================================*/
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <gsim/se_lct.h>
+
+# ifndef GS_WINDOWS
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# endif
+
+//=============================== snapshot format ==================================
+
+/* A snapshot is the header below followed by these arrays, in this order:
+   int   T[5*ns+nv+ne+nf+1]  connectivity, see SeMeshBase::get_topology()
+   float vp[2*nv]            vertex coordinates
+   char  vf[2*nv]            vertex refinement and border flags (padded to 4 bytes)
+   float ec[2*ne]            edge clearances ca and cb
+   int   eo[ne+1]            offsets of the constraint ids of each edge in ids
+   int   ids[nids]           constraint ids
+   int   pt[3*npols]         inserted polygons: offset in pv, size (-1 if no polygon), open flag
+   int   pv[npolv]           vertex indices of the inserted polygons
+   Values are stored in the byte order of the machine which saved the file. */
+struct SnapHeader
+ { char signature[8];   // "SeLctSnp"
+   int version;
+   int byteorder;       // 1 in the byte order of the file
+   int ns, nv, ne, nf;  // number of symedges, vertices, edges and faces
+   int nids, npols, npolv;
+   int backface;        // index of the back face
+   int mode, flags;     // triangulator mode, flags: 1 pre_clearance, 2 auto_refinement
+   double epsilon, epsilonedg;
+   float xmin, xmax, ymin, ymax, radius, reserved;
+ };
+
+static const int SnapVersion = 1;
+
+static inline long pad4 ( long n ) { return (n+3)&~3L; }
+
+// size in bytes of the file described by h
+static long snapsize ( const SnapHeader& h )
+ {
+   long s = sizeof(SnapHeader);
+   s += 4L*(5L*h.ns+h.nv+h.ne+h.nf+1);
+   s += 4L*2*h.nv + pad4(2L*h.nv);
+   s += 4L*2*h.ne + 4L*(h.ne+1) + 4L*h.nids;
+   s += 4L*3*h.npols + 4L*h.npolv;
+   return s;
+ }
+
+template <class X>
+static bool fwritea ( const GsArray<X>& a, FILE* f )
+ {
+   return a.size()==0 || fwrite ( &a.cget(0), sizeof(X), a.size(), f )==(size_t)a.size();
+ }
+
+//=============================== save ==================================
+
+bool SeLct::save_snapshot ( const char* filename )
+ {
+   if ( !_backface ) return false;
+   if ( _dcdt_changed ) refine ();
+
+   GsArray<SeBase*> S;
+   GsArray<SeElement*> V, E, F;
+   GsArray<int> T;
+   mesh()->get_topology ( S, V, E, F, T );
+
+   int i, j;
+   SnapHeader h;
+   memset ( &h, 0, sizeof(h) );
+   memcpy ( h.signature, "SeLctSnp", 8 );
+   h.version = SnapVersion;
+   h.byteorder = 1;
+   h.ns = S.size(); h.nv = V.size(); h.ne = E.size(); h.nf = F.size();
+   h.backface = -1;
+   for ( i=0; i<h.nf; i++ ) if ( F[i]==_backface ) { h.backface=i; break; }
+   h.mode = (int)_mode;
+   h.flags = (_pre_clearance? 1:0) | (_auto_refinement? 2:0);
+   h.epsilon = _epsilon;
+   h.epsilonedg = _epsilonedg;
+   h.xmin = _xmin; h.xmax = _xmax; h.ymin = _ymin; h.ymax = _ymax;
+   h.radius = _radius;
+
+   // vertex data, and the index of each vertex by element id:
+   GsArray<float> vp(2*h.nv);
+   GsArray<char> vf ( (int)pad4(2L*h.nv) );
+   GsArray<int> vindex ( mesh()->idbound() );
+   vf.setall ( 0 );
+   for ( i=0; i<h.nv; i++ )
+    { SeDcdtVertex* v = (SeDcdtVertex*)V[i];
+      vp[2*i] = v->p.x; vp[2*i+1] = v->p.y;
+      vf[2*i] = v->refinement; vf[2*i+1] = v->border;
+      vindex[v->id()] = i;
+    }
+
+   // edge data:
+   GsArray<float> ec(2*h.ne);
+   GsArray<int> eo(h.ne+1), ids;
+   for ( i=0; i<h.ne; i++ )
+    { SeDcdtEdge* e = (SeDcdtEdge*)E[i];
+      ec[2*i] = e->ca; ec[2*i+1] = e->cb;
+      eo[i] = ids.size();
+      for ( j=0; j<e->ids.size(); j++ ) ids.push() = e->ids[j];
+    }
+   eo[h.ne] = ids.size();
+   h.nids = ids.size();
+
+   // inserted polygons:
+   GsArray<int> pt, pv;
+   for ( i=0; i<=_polygons.maxid(); i++ )
+    { InsPol* p = _polygons[i];
+      pt.push() = pv.size();
+      pt.push() = p? p->size():-1;
+      pt.push() = p? p->open:0;
+      if ( p ) for ( j=0; j<p->size(); j++ ) pv.push() = vindex[p->get(j)->id()];
+    }
+   h.npols = pt.size()/3;
+   h.npolv = pv.size();
+
+   FILE* f = fopen ( filename, "wb" );
+   if ( !f ) return false;
+   bool ok = fwrite ( &h, sizeof(h), 1, f )==1;
+   ok = ok && fwritea(T,f) && fwritea(vp,f) && fwritea(vf,f) && fwritea(ec,f);
+   ok = ok && fwritea(eo,f) && fwritea(ids,f) && fwritea(pt,f) && fwritea(pv,f);
+   if ( fclose(f)!=0 ) ok=false;
+   return ok;
+ }
+
+//=============================== load ==================================
+
+// maps the whole file read-only, or reads it where mmap is not available
+static const char* mapfile ( const char* filename, long& size )
+ {
+   size = 0;
+# ifdef GS_WINDOWS
+   FILE* f = fopen ( filename, "rb" );
+   if ( !f ) return 0;
+   fseek ( f, 0, SEEK_END );
+   size = ftell ( f );
+   fseek ( f, 0, SEEK_SET );
+   char* buf = (char*) malloc ( size>0? size:1 );
+   if ( fread(buf,1,size,f)!=(size_t)size ) { free(buf); buf=0; }
+   fclose ( f );
+   return buf;
+# else
+   int fd = open ( filename, O_RDONLY );
+   if ( fd<0 ) return 0;
+   struct stat st;
+   void* pt = MAP_FAILED;
+   if ( fstat(fd,&st)==0 && st.st_size>0 )
+    { size = (long)st.st_size;
+      pt = mmap ( 0, (size_t)size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    }
+   close ( fd );
+   return pt==MAP_FAILED? 0 : (const char*)pt;
+# endif
+ }
+
+static void unmapfile ( const char* buf, long size )
+ {
+# ifdef GS_WINDOWS
+   free ( (void*)buf );
+# else
+   munmap ( (void*)buf, (size_t)size );
+# endif
+ }
+
+bool SeLct::load_snapshot ( const char* filename )
+ {
+   long size;
+   const char* buf = mapfile ( filename, size );
+   if ( !buf ) return false;
+
+   SnapHeader h;
+   bool ok = size>=(long)sizeof(h);
+   if ( ok ) memcpy ( &h, buf, sizeof(h) );
+   ok = ok && memcmp(h.signature,"SeLctSnp",8)==0 && h.version==SnapVersion && h.byteorder==1;
+   ok = ok && h.ns>0 && h.nv>0 && h.ne>0 && h.nf>0 && h.nids>=0 && h.npols>0 && h.npolv>=0;
+   ok = ok && h.backface>=0 && h.backface<h.nf && snapsize(h)==size;
+   if ( !ok ) { unmapfile(buf,size); return false; }
+
+   const int* T = (const int*)(buf+sizeof(h));
+   const float* vp = (const float*)(T+5*h.ns+h.nv+h.ne+h.nf+1);
+   const char* vf = (const char*)(vp+2*h.nv);
+   const float* ec = (const float*)(vf+pad4(2L*h.nv));
+   const int* eo = (const int*)(ec+2*h.ne);
+   const int* ids = eo+h.ne+1;
+   const int* pt = ids+h.nids;
+   const int* pv = pt+3*h.npols;
+
+   int i, j;
+   ok = eo[0]==0 && eo[h.ne]==h.nids;
+   for ( i=0; ok && i<h.ne; i++ ) if ( eo[i+1]<eo[i] ) ok=false;
+   for ( i=0; ok && i<h.npols; i++ ) if ( pt[3*i+1]>=0 && (pt[3*i]<0 || pt[3*i]+pt[3*i+1]>h.npolv) ) ok=false;
+   for ( i=0; ok && i<h.npolv; i++ ) if ( pv[i]<0 || pv[i]>=h.nv ) ok=false;
+   if ( !ok ) { unmapfile(buf,size); return false; }
+
+   _polygons.init();
+   _backface = 0;
+   GsArray<SeElement*> V, E, F;
+   if ( !mesh()->set_topology(h.ns,h.nv,h.ne,h.nf,T,V,E,F) ) { unmapfile(buf,size); return false; }
+
+   for ( i=0; i<h.nv; i++ )
+    { SeDcdtVertex* v = (SeDcdtVertex*)V[i];
+      v->p.set ( vp[2*i], vp[2*i+1] );
+      v->refinement = vf[2*i];
+      v->border = vf[2*i+1];
+    }
+
+   for ( i=0; i<h.ne; i++ )
+    { SeDcdtEdge* e = (SeDcdtEdge*)E[i];
+      e->ca = ec[2*i]; e->cb = ec[2*i+1];
+      e->ids.size ( eo[i+1]-eo[i] );
+      for ( j=0; j<e->ids.size(); j++ ) e->ids[j] = ids[eo[i]+j];
+    }
+
+   // polygons are first all inserted to keep their ids, and then the gaps are removed:
+   for ( i=0; i<h.npols; i++ )
+    { InsPol& p = *_polygons[_polygons.insert()];
+      if ( pt[3*i+1]<0 ) continue;
+      p.size ( pt[3*i+1] );
+      p.open = (gscbool)pt[3*i+2];
+      for ( j=0; j<p.size(); j++ ) p[j] = (SeDcdtVertex*)V[pv[pt[3*i]+j]];
+    }
+   for ( i=0; i<h.npols; i++ ) if ( pt[3*i+1]<0 ) _polygons.remove(i);
+
+   _backface = (SeDcdtFace*)F[h.backface];
+   _cur_search_face = 0;
+   _mode = (Mode)h.mode;
+   epsilon ( h.epsilon );
+   epsilonedg ( h.epsilonedg );
+   _xmin = h.xmin; _xmax = h.xmax; _ymin = h.ymin; _ymax = h.ymax;
+   _radius = h.radius;
+   _pre_clearance = (h.flags&1)? true:false;
+   _auto_refinement = (h.flags&2)? true:false;
+   _dcdt_changed = false; // already refined, with clearances
+   _version++;
+   clear_landmarks ();
+   clear_junction_graph ();
+   clear_frozen_mesh ();
+   _build_locgrid ();
+   _save_facesigs ();
+   _edits.size ( 0 );
+   _editall = false;
+   _clear_path ();
+
+   unmapfile ( buf, size );
+   return true;
+ }
+
+//============================ End of File ===============================
@@ -264,7 +264,7 @@ void SeLct::_collect_entrance_disturbances (
 
    // test if point is a valid disturbance:
    GsArray<GsPnt2>& fp = _ent[i].fp;
-   if ( !_mesh->marked(v) && 
+   if ( !_marked(v) && 
         gs_ccw(c.bx,c.by,fp[fst].x,fp[fst].y,x3,y3)>0 &&
         gs_ccw(x3,y3,fp.top().x,fp.top().y,c.ax,c.ay)>0 &&
         gs_point_segment_dist2(x3,y3,c.ax,c.ay,c.bx,c.by)<c.r2 )
@@ -280,7 +280,7 @@ void SeLct::_collect_entrance_disturbances (
     }
 
    // mark point as already tested:
-   _mesh->mark(v);
+   _mark(v);
    if ( i==3 ) _elembuffer.push().set(v,0);
 
    // if current edge is constrained, do not further recurse:
@@ -291,15 +291,15 @@ void SeLct::_collect_entrance_disturbances (
    SeBase* sp = sn->nxt();
    _man->get_vertex_coordinates ( sp->vtx(), x3, y3 );
 
-   if ( !_mesh->marked(sn->edg()) )
-    { _mesh->mark(sn->edg());
+   if ( !_marked(sn->edg()) )
+    { _mark(sn->edg());
       if ( i==3 ) _elembuffer.push().set(0,sn);
       if ( gs_segment_segment_dist2(x1,y1,x3,y3,c.ax,c.ay,c.bx,c.by)<c.r2 )
         _collect_entrance_disturbances ( i, fst, top, sn, sp->vtx(), x1, y1, x3, y3, c );
     }
 
-   if ( !_mesh->marked(sp->edg()) )
-    { _mesh->mark(sp->edg());
+   if ( !_marked(sp->edg()) )
+    { _mark(sp->edg());
       if ( i==3 ) _elembuffer.push().set(0,sp);
       if ( gs_segment_segment_dist2(x3,y3,x2,y2,c.ax,c.ay,c.bx,c.by)<c.r2 )
         _collect_entrance_disturbances ( i, fst, top, sp, sp->vtx(), x3, y3, x2, y2, c );
@@ -343,13 +343,13 @@ bool SeLct::_analyze_entrance_side ( SeBase* s, int i, bool main, bool top, doub
       x = x1+(cx-tx); y = y1+(cy-ty); // capsule end-point at entrance edge
       fp[fst].set ( tx, ty );
       fp[fst+1].set ( x1, y1 );
-      if ( i<3 ) _mesh->begin_marking(); else _elembuffer.push().set(0,sp);
-      _mesh->mark(sp->edg());
+      if ( i<3 ) _begin_marking(); else _elembuffer.push().set(0,sp);
+      _mark(sp->edg());
       GS_TRACE2 ( "AnaEnt: getting bottom" );
       SetCapsule ( c, r*r, x, y, cx, cy );
       _collect_entrance_disturbances ( i, fst, top, sp, sp->vtx(), x3, y3, x1, y1, c ); // main side
       _collect_entrance_disturbances ( i, fst, top, sn, sp->vtx(), x2, y2, x3, y3, c ); // extra
-      if ( i<3 ) _mesh->end_marking();
+      if ( i<3 ) _end_marking();
     }
    else
     { top = true; // top entrance
@@ -361,13 +361,13 @@ bool SeLct::_analyze_entrance_side ( SeBase* s, int i, bool main, bool top, doub
       x = x2+(cx-tx); y = y2+(cy-ty); // capsule end-point at entrance edge
       fp[fst].set ( x2, y2 );
       fp[fst+1].set ( tx, ty );
-      if ( i<3 ) _mesh->begin_marking(); else _elembuffer.push().set(0,sn);
-      _mesh->mark(sn->edg());
+      if ( i<3 ) _begin_marking(); else _elembuffer.push().set(0,sn);
+      _mark(sn->edg());
       GS_TRACE2 ( "AnaEnt: getting top" );
       SetCapsule ( c, r*r, cx, cy, x, y );
       _collect_entrance_disturbances ( i, fst, top, sn, sp->vtx(), x2, y2, x3, y3, c ); // main side
       _collect_entrance_disturbances ( i, fst, top, sp, sp->vtx(), x3, y3, x1, y1, c ); // extra
-      if ( i<3 ) _mesh->end_marking();
+      if ( i<3 ) _end_marking();
       fv.revert(fst,fv.size()-1);
       fp.revert(fst,fp.size()-1);
     }
@@ -480,7 +480,7 @@ void SeLct::_analyze_arrival ( SeBase* s, int i, double r, float d2, SeDcdtSymEd
    // analysis in order to leave the marking consistent:
    while ( _elembuffer.size()>0 )
     { ConstrElem& c = _elembuffer.pop();
-      mesh()->unmark ( c.v? c.v : c.e->edg() );
+      _unmark ( c.v? c.v : c.e->edg() );
     }
 
    if ( _ent[i].type==EntBlocked ) return; // entrance blocked
@@ -504,7 +504,7 @@ void SeLct::_collect_capsule_disturbances
    // and a seg-seg test below is not needed:
    // if ( gs_segment_segment_dist2(c1x,c1y,c2x,c2y,x1,y1,x2,y2)>=r2 ) return; // ok enought space
 
-   _mesh->mark ( s->edg() );
+   _mark ( s->edg() );
 
    // check if there are disturbing vertices:
    double t;
@@ -512,14 +512,14 @@ void SeLct::_collect_capsule_disturbances
    SeVertex* v1 = s->vtx();
    SeVertex* v2 = s->nxt()->vtx();
 
-   if ( !_mesh->marked(v1) )
-    { _mesh->mark(v1);
+   if ( !_marked(v1) )
+    { _mark(v1);
       if ( gs_point_segment_dist2 ( x1, y1, c.ax, c.ay, c.bx, c.by, t )<c.r2 )
        { _ent[1].fv.push()=v1; _ent[1].fp.push().set(x1,y1); vfound=true; }
     }
 
-   if ( !_mesh->marked(v2) )
-    { _mesh->mark(v2); 
+   if ( !_marked(v2) )
+    { _mark(v2); 
       if ( gs_point_segment_dist2 ( x2, y2, c.ax, c.ay, c.bx, c.by, t )<c.r2 )
        { _ent[1].fv.push()=v2; _ent[1].fp.push().set(x2,y2); vfound=true; }
     }
@@ -539,12 +539,12 @@ void SeLct::_collect_capsule_disturbances
    SeBase* sp = sn->nxt();
    double x3, y3;
    _man->get_vertex_coordinates ( sp->vtx(), x3, y3 );
-   if ( !_mesh->marked(sp->edg()) )
+   if ( !_marked(sp->edg()) )
     if ( gs_ccw(sec.cx,sec.cy,x3,y3,sec.bx,sec.by)>0 ) // c-p3-b
      { _collect_capsule_disturbances ( sp, x3, y3, x2, y2, c, sec );
      }
 
-   if ( !_mesh->marked(sn->edg()) )
+   if ( !_marked(sn->edg()) )
     if ( gs_ccw(sec.cx,sec.cy,sec.ax,sec.ay,x3,y3)>0 ) // c-a-p3
      { _collect_capsule_disturbances ( sn, x1, y1, x3, y3, c, sec );
      }
@@ -572,12 +572,12 @@ SeLct::PathResult SeLct::_analyze_local_path ( SeBase* s, double r )
    #define SetCapsule(c,w,s,t,u,v)  c.r2=w; c.ax=s; c.ay=t; c.bx=u; c.by=v
    Capsule cap;
    SetCapsule(cap,r2,_xi,_yi,_xg,_yg);
-   _mesh->begin_marking ();
+   _begin_marking ();
    Sector sec;
    SetSector(sec,x3,y3,x1,y1,x2,y2); _collect_capsule_disturbances ( s,  x1,y1,x2,y2, cap,sec );
    SetSector(sec,x1,y1,x2,y2,x3,y3); _collect_capsule_disturbances ( sn, x2,y2,x3,y3, cap,sec );
    SetSector(sec,x2,y2,x3,y3,x1,y1); _collect_capsule_disturbances ( sp, x3,y3,x1,y1, cap,sec );
-   _mesh->end_marking ();
+   _end_marking ();
    #undef SetCapsule
 
    // check if there are disturbances:
@@ -0,0 +1,318 @@
+/*=======================================================================
+   Copyright 2010 Marcelo Kallmann. All Rights Reserved.
+   This software is distributed for noncommercial use only, without
+   any warranties, and provided that all copies contain the full copyright
+   notice licence.txt located at the base folder of the distribution.
+  =======================================================================*/
+
+# include <math.h>
+# include <gsim/se_lct.h>
+# include "se_triangulator_internal.h"
+
+//# define GS_USE_TRACE1 // changed regions
+# include <gsim/gs_trace.h>
+
+//================================================================================
+//============================= incremental updates ==============================
+//================================================================================
+
+static bool border ( SeDcdtFace* f )
+ {
+   SeDcdtSymEdge* s = f->se();
+   return s->vtx()->border || s->nxt()->vtx()->border || s->nxn()->vtx()->border;
+ }
+
+static float longest ( SeDcdtFace* f )
+ {
+   SeDcdtSymEdge* s = f->se();
+   const GsPnt2& a = s->vtx()->p;
+   const GsPnt2& b = s->nxt()->vtx()->p;
+   const GsPnt2& c = s->nxn()->vtx()->p;
+   return sqrtf ( GS_MAX(GS_MAX(dist2(a,b),dist2(b,c)),dist2(c,a)) );
+ }
+
+// true if the bounding box of f expanded by m overlaps box (xmin,ymin,xmax,ymax)
+static bool overlaps ( SeDcdtFace* f, const float* box, float m )
+ {
+   SeDcdtSymEdge* s = f->se();
+   const GsPnt2& a = s->vtx()->p;
+   const GsPnt2& b = s->nxt()->vtx()->p;
+   const GsPnt2& c = s->nxn()->vtx()->p;
+   if ( GS_MIN(GS_MIN(a.x,b.x),c.x)-m>box[2] || GS_MAX(GS_MAX(a.x,b.x),c.x)+m<box[0] ) return false;
+   if ( GS_MIN(GS_MIN(a.y,b.y),c.y)-m>box[3] || GS_MAX(GS_MAX(a.y,b.y),c.y)+m<box[1] ) return false;
+   return true;
+ }
+
+// Mesh operators reuse the face records (e.g. in flips), so changed faces are found by
+// comparing vertex ids, which are not reused until _compact_ids() saves all signatures
+// again, and the constrained state of the edges.
+void SeLct::_facesig ( SeDcdtFace* f, FaceSig& sig )
+ {
+   SeDcdtSymEdge* s = f->se();
+   if ( s->nxt()->vtx()->id()<s->vtx()->id() ) s=s->nxt();
+   if ( s->nxt()->vtx()->id()<s->vtx()->id() ) s=s->nxt();
+   sig.c = 0;
+   for ( int k=0; k<3; k++, s=s->nxt() )
+    { sig.v[k] = s->vtx()->id();
+      if ( _man->is_constrained(s->edg()) ) sig.c |= 1<<k;
+    }
+ }
+
+void SeLct::_save_facesigs ()
+ {
+   _fsig.size ( _mesh->idbound() );
+   _maxedge = 0;
+   for ( SeDcdtFace* f=_backface->nxt(); f!=_backface; f=f->nxt() )
+    { _facesig ( f, _fsig[f->id()] );
+      if ( !border(f) ) _maxedge = GS_MAX ( _maxedge, longest(f) );
+    }
+ }
+
+bool SeLct::_changed ( SeDcdtFace* f )
+ {
+   int id = f->id();
+   if ( id>=_fsig.size() ) return true;
+   FaceSig sig;
+   _facesig ( f, sig );
+   const FaceSig& old = _fsig[id];
+   return sig.v[0]!=old.v[0] || sig.v[1]!=old.v[1] || sig.v[2]!=old.v[2] || sig.c!=old.c;
+ }
+
+// Searches from f the faces changed since the last refinement, also crossing the faces overlapping
+// box if given. Mesh operators only retriangulate regions connected to the inserted or removed
+// vertices and constraints, so the search from an edited polygon or a new vertex reaches all faces
+// it changed. Changed faces extend _updbox and _maxedge, and are counted in n.
+void SeLct::_grow_changes ( SeDcdtFace* f, const float* box, int& n )
+ {
+   if ( _marked(f) ) return;
+   GsArray<SeDcdtFace*>& queue = _updfaces;
+   queue.size ( 0 );
+   queue.push() = f;
+   _mark ( f );
+   for ( int i=0; i<queue.size(); i++ )
+    { f = queue[i];
+      SeDcdtSymEdge* s = f->se();
+      if ( _changed(f) )
+       { for ( int k=0; k<3; k++, s=s->nxt() )
+          { const GsPnt2& p = s->vtx()->p;
+            if ( n==0 && k==0 ) { _updbox[0]=_updbox[2]=p.x; _updbox[1]=_updbox[3]=p.y; }
+            if ( p.x<_updbox[0] ) _updbox[0]=p.x; else if ( p.x>_updbox[2] ) _updbox[2]=p.x;
+            if ( p.y<_updbox[1] ) _updbox[1]=p.y; else if ( p.y>_updbox[3] ) _updbox[3]=p.y;
+          }
+         if ( !border(f) ) _maxedge = GS_MAX ( _maxedge, longest(f) );
+         n++;
+       }
+      for ( int k=0; k<3; k++, s=s->nxt() )
+       { SeDcdtFace* g = s->sym()->fac();
+         if ( g==_backface || _marked(g) ) continue;
+         if ( !_changed(g) && !(box && overlaps(g,box,0)) ) continue;
+         _mark ( g );
+         queue.push() = g;
+       }
+    }
+ }
+
+// Starts an update from the boxes of the edited polygons, returning false if nothing changed
+bool SeLct::_find_changes ()
+ {
+   SeBase* s;
+   int i, n=0;
+   GsArray<SeDcdtFace*> seeds; // located before marking, which locate_point() may use
+   seeds.size ( _edits.size()/4 );
+   for ( i=0; i<seeds.size(); i++ )
+    { const float* b = &_edits[4*i];
+      bool found = locate_point(get_search_face(),(b[0]+b[2])/2.0f,(b[1]+b[3])/2.0f,s,false)!=NotFound;
+      seeds[i] = found? (SeDcdtFace*)s->fac() : 0;
+    }
+   _begin_marking ();
+   for ( i=0; i<seeds.size(); i++ )
+    { if ( seeds[i] ) _grow_changes ( seeds[i], &_edits[4*i], n );
+    }
+   _end_marking ();
+   GS_TRACE1 ( "Changed faces: "<<n<<" in "<<_updbox[0]<<","<<_updbox[1]<<" - "<<_updbox[2]<<","<<_updbox[3] );
+   return n>0;
+ }
+
+// Extends the update with the faces changed by the vertices inserted in a refinement iteration
+void SeLct::_find_new_changes ()
+ {
+   int n=1; // _updbox is already initialized
+   _begin_marking ();
+   for ( int i=0; i<_updverts.size(); i++ )
+    { SeDcdtSymEdge *s, *si;
+      s = si = _updverts[i]->se();
+      do { if ( s->fac()!=_backface ) _grow_changes ( s->fac(), 0, n );
+           s = s->rot();
+         } while ( s!=si );
+    }
+   _end_marking ();
+   _updverts.size ( 0 );
+ }
+
+// Collects in _updfaces the faces with bounding boxes overlapping _updbox expanded by _maxedge,
+// which include all faces intersecting this expanded box and thus forming a connected region.
+void SeLct::_collect_region ()
+ {
+   SeBase* s;
+   _updfaces.size ( 0 );
+   if ( locate_point(get_search_face(),(_updbox[0]+_updbox[2])/2.0f,(_updbox[1]+_updbox[3])/2.0f,s,false)==NotFound ) return;
+   SeDcdtFace* f = (SeDcdtFace*)s->fac();
+   _begin_marking ();
+   _mark ( f );
+   _updfaces.push() = f;
+   for ( int i=0; i<_updfaces.size(); i++ )
+    { SeDcdtSymEdge* e = _updfaces[i]->se();
+      for ( int k=0; k<3; k++, e=e->nxt() )
+       { SeDcdtFace* g = e->sym()->fac();
+         if ( g==_backface || _marked(g) || !overlaps(g,_updbox,_maxedge) ) continue;
+         _mark ( g );
+         _updfaces.push() = g;
+       }
+    }
+   _end_marking ();
+   GS_TRACE1 ( "Region faces: "<<_updfaces.size() );
+ }
+
+// The clearance and refinement tests of a face only reach geometry closer to it than its
+// longest edge, so faces farther than that from the changed box are not affected.
+bool SeLct::_depends ( SeDcdtFace* f )
+ {
+   return !border(f) && overlaps ( f, _updbox, longest(f) );
+ }
+
+// collects in _earray the refinements needed in the faces depending on the changes
+void SeLct::_collect_refinements ( RefinementType type )
+ {
+   SeDcdtSymEdge *s, *sub, *dv;
+   _collect_region ();
+   for ( int i=0; i<_updfaces.size(); i++ )
+    { SeDcdtFace* f = _updfaces[i];
+      if ( !_depends(f) ) continue;
+      s = f->se();
+      for ( int k=0; k<3; k++, s=s->nxt() )
+       { sub = _needs_refinement(s,type,dv);
+         if ( sub ) { _earray.push()=s; _earray.push()=sub; _earray.push()=dv; }
+       }
+    }
+ }
+
+// Appends to _reffaces the faces whose refinement tests may have changed with the insertion of v:
+// the faces of its star, which replaced the ones the insertion destroyed, and the faces around them
+// closer to the star than their longest edge, as in _depends(). Faces only connected to the star
+// through farther ones are left to the scan that confirms the end of the refinement.
+void SeLct::_refine_neighbours ( SeDcdtVertex* v )
+ {
+   SeDcdtSymEdge *s, *si;
+   float box[4];
+   box[0]=box[2]=v->p.x; box[1]=box[3]=v->p.y;
+   int i0 = _reffaces.size();
+   _begin_marking ();
+   s = si = v->se();
+   do { const GsPnt2& p = s->nxt()->vtx()->p;
+        if ( p.x<box[0] ) box[0]=p.x; else if ( p.x>box[2] ) box[2]=p.x;
+        if ( p.y<box[1] ) box[1]=p.y; else if ( p.y>box[3] ) box[3]=p.y;
+        if ( s->fac()!=_backface ) { _mark(s->fac()); _reffaces.push()=s->fac(); }
+        s = s->rot();
+      } while ( s!=si );
+   for ( int i=i0; i<_reffaces.size(); i++ )
+    { SeDcdtSymEdge* e = _reffaces[i]->se();
+      for ( int k=0; k<3; k++, e=e->nxt() )
+       { SeDcdtFace* g = e->sym()->fac();
+         if ( g==_backface || _marked(g) ) continue;
+         _mark ( g );
+         if ( border(g) || !overlaps(g,box,longest(g)) ) continue;
+         _reffaces.push() = g;
+       }
+    }
+   _end_marking ();
+ }
+
+// collects in _earray the refinements needed in _reffaces, which is emptied
+void SeLct::_collect_neighbour_refinements ( RefinementType type )
+ {
+   SeDcdtSymEdge *s, *sub, *dv;
+   int i, n=0;
+   _begin_marking (); // the stars of close vertices share faces
+   for ( i=0; i<_reffaces.size(); i++ )
+    { if ( _marked(_reffaces[i]) ) continue;
+      _mark ( _reffaces[i] );
+      _reffaces[n++] = _reffaces[i];
+    }
+   _end_marking ();
+   _reffaces.size ( n );
+   for ( i=0; i<n; i++ )
+    { s = _reffaces[i]->se();
+      for ( int k=0; k<3; k++, s=s->nxt() )
+       { sub = _needs_refinement(s,type,dv);
+         if ( sub ) { _earray.push()=s; _earray.push()=sub; _earray.push()=dv; }
+       }
+    }
+   _reffaces.size ( 0 );
+ }
+
+// updates the clearances, the signatures and the location grid in the region of the changes
+void SeLct::_finish_update ()
+ {
+   int n = _mesh->idbound();
+   if ( _fsig.capacity()<n ) _fsig.capacity ( 2*n ); // ids grow until compacted
+   _fsig.size ( n );
+
+   _collect_region ();
+   for ( int i=0; i<_updfaces.size(); i++ )
+    { SeDcdtFace* f = _updfaces[i];
+      if ( _pre_clearance && _depends(f) ) _face_clearance ( f );
+      _facesig ( f, _fsig[f->id()] ); // the region contains all changed faces
+    }
+   _update_locgrid ();
+ }
+
+// Relocates the grid cells with centers in _updbox, as only there faces may have been
+// removed or changed. The grid is rebuilt if the number of faces changed too much, or if
+// it is shared with query contexts.
+void SeLct::_update_locgrid ()
+ {
+   LocGrid& g = *_lg;
+   int n = _mesh->faces()/2;
+   if ( g.cells.empty() || n>2*g.nx*g.ny || 2*n<g.nx*g.ny || _lg->getref()>1 ) { _build_locgrid(); return; }
+
+   // one extra cell on each side covers rounding errors:
+   int i0 = int ( floor((_updbox[0]-g.x)/g.cw) )-1; if ( i0<0 ) i0=0;
+   int i1 = int ( floor((_updbox[2]-g.x)/g.cw) )+1; if ( i1>=g.nx ) i1=g.nx-1;
+   int j0 = int ( floor((_updbox[1]-g.y)/g.ch) )-1; if ( j0<0 ) j0=0;
+   int j1 = int ( floor((_updbox[3]-g.y)/g.ch) )+1; if ( j1>=g.ny ) j1=g.ny-1;
+
+   SeBase* s;
+   const SeFace* f = _updfaces.size()? _updfaces[0] : get_search_face();
+   for ( int j=j0; j<=j1; j++ )
+    for ( int k=i0; k<=i1; k++ )
+     { int i = j%2? i1-(k-i0) : k; // rows alternate direction so that each walk is short
+       if ( locate_point(f,g.x+g.cw*(i+0.5f),g.y+g.ch*(j+0.5f),s,false)!=NotFound ) f=s->fac();
+       g.cells[j*g.nx+i] = (SeDcdtFace*)f;
+     }
+ }
+
+// Ids of destroyed elements are not reused, so polygon edits keep increasing the ids and
+// the arrays indexed by them. When most ids are unused the mesh elements are renumbered,
+// the arrays are shrunk and the signatures are saved with the new vertex ids.
+void SeLct::_compact_ids ()
+ {
+   int n = _mesh->vertices()+_mesh->edges()+_mesh->faces();
+   if ( _mesh->idbound()<=2*n ) return;
+
+   GS_TRACE1 ( "Compacting ids: "<<_mesh->idbound()<<" -> "<<n );
+   _mesh->compact_ids ();
+   _goals.ids.size ( 0 );
+   _goals.ids.compress ();
+   _jgallow.size ( 0 );
+   _jgallow.compress ();
+   if ( _bi )
+    { _bi->visited.size(0); _bi->visited.compress();
+      _bi->onpath.size(0); _bi->onpath.compress();
+      _bi->crossed.size(0); _bi->crossed.compress();
+    }
+   _fsig.size ( 0 );
+   _fsig.compress ();
+   _save_facesigs ();
+ }
+
+//============================ End of File ===============================
@@ -27,6 +27,7 @@ void SeMeshBase::_defaults ()
    _marking = false;
    _indexing = false;
    _vertices = _edges = _faces = 0; 
+   _nextid = 0;
  }
 
 SeBase* SeMeshBase::_op_error ( OpMsg m )
@@ -94,6 +95,21 @@ int SeMeshBase::elems ( ElemType type ) const
    return 0;
  }
 
+int SeMeshBase::compact_ids ()
+ {
+   _nextid = 0;
+   if ( !_first ) return 0;
+
+   SeElement *e, *ei;
+   e = ei = _first->vtx();
+   do { e->_id=_nextid++; e=e->nxt(); } while ( e!=ei );
+   e = ei = _first->edg();
+   do { e->_id=_nextid++; e=e->nxt(); } while ( e!=ei );
+   e = ei = _first->fac();
+   do { e->_id=_nextid++; e=e->nxt(); } while ( e!=ei );
+   return _nextid;
+ }
+
 void SeMeshBase::invert_faces ()
  {
    SeBase *se;
@@ -223,6 +239,31 @@ void SeMeshBase::unmark ( SeElement* e )
    e->_index = _curmark-1;
  }
 
+//============================ SeMeshMarker =====================================
+
+void SeMeshMarker::begin_marking ( const SeMeshBase* m )
+ {
+   int i = _marks.size();
+   int n = m->idbound();
+
+   if ( i>2*n ) // the ids of the mesh were compacted
+    { _marks.size ( n );
+      _marks.compress ();
+      i = n;
+    }
+
+   if ( _curmark==se_index_max_value )
+    { _marks.setall ( 0 );
+      _curmark = 1;
+    }
+   else _curmark++;
+
+   if ( i<n ) // new elements start unmarked
+    { _marks.size ( n );
+      while ( i<n ) _marks[i++]=0;
+    }
+ }
+
 //============================ SeMeshBase indexing =====================================
 
 void SeMeshBase::begin_indexing ()
@@ -126,6 +126,7 @@ void SeMeshBase::_elemload ( GsInput& inp, GsArray<SeElement*>& E,
     { x = inp.geti();
       E[i] = (SeElement*)man->alloc();
       E[i]->_symedge = S.get(x);
+      E[i]->_id = _nextid++;
       man->input ( inp, E[i] );
       //man->read ( E[i], f );
       if ( i>0 ) E[0]->_insert(E[i]);
@@ -151,7 +152,7 @@ bool SeMeshBase::load ( GsInput& inp )
    i = inp.getl();
    GsArray<SeBase*> S(i);
    for ( i=0; i<S.size(); i++ )
-    { S[i] = new SeBase;
+    { S[i] = _sepool.alloc();
       S[i]->_next   = (SeBase*)inp.getl();
       S[i]->_rotate = (SeBase*)inp.getl();
       S[i]->_vertex = (SeVertex*)inp.getl();
@@ -188,5 +189,108 @@ bool SeMeshBase::load ( GsInput& inp )
    GS_TRACE1 ( "load OK !" );
    return true;
  }
+
+//---------------------------------- topology --------------------------------
+
+// index of symedge s, when edge indices are stored in the edges _index
+# define SID(s) ( 2*int(s->_edge->_index) + (s==s->_edge->_symedge? 0:1) )
+
+void SeMeshBase::get_topology ( GsArray<SeBase*>& S, GsArray<SeElement*>& V, GsArray<SeElement*>& E,
+                                GsArray<SeElement*>& F, GsArray<int>& T )
+ {
+   SeElement *el, *eli;
+   int i;
+
+   S.size(0); V.size(0); E.size(0); F.size(0); T.size(0);
+   if ( empty() ) return;
+
+   begin_indexing ();
+
+   el = eli = _first->edg();
+   do { el->_index = E.size();
+        E.push() = el;
+        S.push() = el->_symedge;
+        S.push() = el->_symedge->sym();
+        el = el->nxt();
+      } while ( el!=eli );
+
+   el = eli = _first->vtx();
+   do { el->_index = V.size(); V.push()=el; el=el->nxt(); } while ( el!=eli );
+
+   el = eli = _first->fac();
+   do { el->_index = F.size(); F.push()=el; el=el->nxt(); } while ( el!=eli );
+
+   T.size ( 5*S.size()+V.size()+E.size()+F.size()+1 );
+   int* t = &T[0];
+   for ( i=0; i<S.size(); i++ )
+    { *t++ = SID(S[i]->_next);
+      *t++ = SID(S[i]->_rotate);
+      *t++ = int(S[i]->_vertex->_index);
+      *t++ = int(S[i]->_edge->_index);
+      *t++ = int(S[i]->_face->_index);
+    }
+   for ( i=0; i<V.size(); i++ ) *t++ = SID(V[i]->_symedge);
+   for ( i=0; i<E.size(); i++ ) *t++ = SID(E[i]->_symedge);
+   for ( i=0; i<F.size(); i++ ) *t++ = SID(F[i]->_symedge);
+   *t = SID(_first);
+
+   end_indexing ();
+ }
+
+# undef SID
+
+static void _newelems ( GsArray<SeElement*>& E, int n, GsManagerBase* man )
+ {
+   E.size ( n );
+   for ( int i=0; i<n; i++ ) E[i] = (SeElement*)man->alloc();
+ }
+
+bool SeMeshBase::set_topology ( int ns, int nv, int ne, int nf, const int* T,
+                                GsArray<SeElement*>& V, GsArray<SeElement*>& E, GsArray<SeElement*>& F )
+ {
+   int i;
+
+   destroy ();
+   V.size(0); E.size(0); F.size(0);
+   if ( ns<=0 ) return ns==0;
+
+   // check all indices before allocating anything:
+   if ( nv<=0 || nf<=0 || ns!=2*ne ) return false;
+   for ( i=0; i<ns; i++ )
+    { const int* t = T+5*i;
+      if ( t[0]<0 || t[0]>=ns || t[1]<0 || t[1]>=ns ) return false;
+      if ( t[2]<0 || t[2]>=nv || t[3]<0 || t[3]>=ne || t[4]<0 || t[4]>=nf ) return false;
+    }
+   for ( i=5*ns; i<=5*ns+nv+ne+nf; i++ ) if ( T[i]<0 || T[i]>=ns ) return false;
+
+   GsArray<SeBase*> S(ns);
+   for ( i=0; i<ns; i++ ) S[i] = _sepool.alloc();
+   _newelems ( V, nv, _vtxman );
+   _newelems ( E, ne, _edgman );
+   _newelems ( F, nf, _facman );
+
+   for ( i=0; i<ns; i++ )
+    { S[i]->_next   = S[T[0]];
+      S[i]->_rotate = S[T[1]];
+      S[i]->_vertex = V[T[2]];
+      S[i]->_edge   = E[T[3]];
+      S[i]->_face   = F[T[4]];
+      T += 5;
+    }
+
+   // element lists keep the given order:
+   for ( i=0; i<nv; i++ ) { V[i]->_symedge=S[*T++]; V[i]->_id=_nextid++; if ( i>0 ) V[0]->_insert(V[i]); }
+   for ( i=0; i<ne; i++ ) { E[i]->_symedge=S[*T++]; E[i]->_id=_nextid++; if ( i>0 ) E[0]->_insert(E[i]); }
+   for ( i=0; i<nf; i++ ) { F[i]->_symedge=S[*T++]; F[i]->_id=_nextid++; if ( i>0 ) F[0]->_insert(F[i]); }
+
+   _first    = S[*T];
+   _vertices = nv;
+   _edges    = ne;
+   _faces    = nf;
+   _curmark  = 1;
+   _marking = _indexing = false;
+
+   return true;
+ }
  
 //=== End of File ===================================================================
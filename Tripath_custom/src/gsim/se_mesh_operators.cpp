@@ -23,7 +23,7 @@
 
 # define SE_MAX3(a,b,c) (a>b? (a>c?(a):(c)):(b>c?(b):(c)))
 
-# define EDG_CREATE(x,y) x=new SeBase; y=new SeBase; \
+# define EDG_CREATE(x,y) x=_sepool.alloc(); y=_sepool.alloc(); \
                          x->_next=y; x->_rotate=x;   \
                          y->_next=x; y->_rotate=y;   
 
@@ -45,6 +45,7 @@ void SeMeshBase::_new_vtx ( SeBase *s )
    _vertices++;
    SeVertex* v = (SeVertex*)_vtxman->alloc();
    v->_symedge = s;
+   v->_id = _nextid++;
    if ( _first ) _first->vtx()->_insert(v);
    s->_vertex = v;
  }
@@ -54,6 +55,7 @@ void SeMeshBase::_new_edg ( SeBase *s )
    _edges++;
    SeEdge* e = (SeEdge*)_edgman->alloc();
    e->_symedge = s;
+   e->_id = _nextid++;
    if ( _first ) _first->edg()->_insert(e);
    s->_edge = e;
  }
@@ -63,6 +65,7 @@ void SeMeshBase::_new_fac ( SeBase *s )
    _faces++;
    SeFace* f = (SeFace*)_facman->alloc();
    f->_symedge = s;
+   f->_id = _nextid++;
    if ( _first ) _first->fac()->_insert(f);
    s->_face = f;
  }
@@ -171,15 +174,7 @@ void SeMeshBase::destroy ()
    int i;
    SeElement *ini, *cur, *curn;
 
-   // Save all symedges in a list:
-   GsArray<SeBase*> S(0,_edges*2);
-   cur = ini = _first->edg();
-   do { S.push() = cur->se();
-        S.push() = cur->se()->sym();
-        cur = cur->nxt();
-      } while ( cur!=ini );
-  
-   // delete element lists :
+   // delete element lists, at once if the manager allocates them in slabs :
    GsManagerBase* man;
    for ( i=0; i<3; i++ ) // for each element type
     { if ( i==0 ) 
@@ -189,15 +184,20 @@ void SeMeshBase::destroy ()
       else  
        { ini=_first->fac(); man=_facman; }
 
+      bool own = man->getref()==1; // a shared manager also has elements of other meshes
+      if ( own && man->free_all() ) continue;
+
       cur=ini;
       do { curn = cur->nxt(); // for each element
            man->free ( cur );
            cur = curn;
 	     } while ( cur!=ini );
+
+      if ( own ) man->free_all(); // elements with destructors are released after being freed
     }
 
    // delete all symedges:
-   for ( i=0; i<S.size(); i++ ) delete S[i];
+   _sepool.clear ();
 
    _defaults ();
 
@@ -336,7 +336,7 @@ SeBase *SeMeshBase::kev ( SeBase *x )
    SeBase *xsp = x->sym()->pri();
    DEF_SPLICE_VARS;
    SPLICE ( xsp, x );
-   delete x->nxt(); delete x;
+   _sepool.free ( x->nxt() ); _sepool.free ( x );
 
    CHECKALL;
    GS_TRACE1("Ok.");
@@ -370,7 +370,7 @@ SeBase *SeMeshBase::kev ( SeBase *x, SeBase **s )
    SPLICE ( xsp, x );
    SPLICE ( xp, xs );
 
-   delete x->nxt(); delete x;
+   _sepool.free ( x->nxt() ); _sepool.free ( x );
 
    x=xp=xp->sym(); xs=xsp->sym();
 
@@ -411,7 +411,7 @@ SeBase *SeMeshBase::kef ( SeBase *x, SeBase **s )
    DEF_SPLICE_VARS;
    SPLICE ( xsp, x );
    SPLICE ( xp, xs );
-   delete x->nxt(); delete x;
+   _sepool.free ( x->nxt() ); _sepool.free ( x );
 
    xp=xp->nxt(); x=xs=xsp->nxt();
 
@@ -456,8 +456,8 @@ SeBase *SeMeshBase::mg ( SeBase *s1, SeBase *s2 ) // elems of s2 will be deleted
    for ( int i=0; i<contour.size(); i+=4 )
     { contour[i+2]->_next->_rotate=contour[i+3];
       contour[i+3]->_next->_rotate=contour[i+2];
-      delete contour[i];
-      delete contour[i+1];
+      _sepool.free ( contour[i] );
+      _sepool.free ( contour[i+1] );
     }
 
    CHECKALL;
@@ -10,7 +10,9 @@
 
 # include <gsim/gs_geo2.h>
 # include <gsim/se_triangulator.h>
+# include <gsim/se_dcdt_manager.h>
 # include "se_triangulator_internal.h"
+# include "se_triangulator_geo.h"
 
 //# define GS_USE_TRACE1 // locate point
 //# define GS_USE_TRACE2 // ins delaunay point
@@ -57,6 +59,8 @@ SeTriangulator::SeTriangulator ( Mode mode, SeMeshBase* m,
    _path_found = false;
    _fdeque = 0;
    _debug_mode = false;
+   _dcdtman = false;
+   _marker = 0;
  }
 
 SeTriangulator::~SeTriangulator ()
@@ -267,9 +271,11 @@ bool SeTriangulator::triangulate_face ( SeFace* f, bool optimize )
 //============================= Locate Point=== ==================================
 //================================================================================
 
-SeTriangulator::LocateResult SeTriangulator::locate_point
+template <class M>
+SeTriangulator::LocateResult SeTriangulator::_locate_point
                              ( const SeFace* iniface, double x, double y, SeBase*& result, bool loctest )
  {
+   M* man = (M*)_man;
    SeVertex *v1, *v2, *v3;
    SeBase *sn, *snn;
    SeBase *s = iniface->se();
@@ -289,8 +295,8 @@ SeTriangulator::LocateResult SeTriangulator::locate_point
       return NotFound;
     }
 
-   _mesh->begin_marking ();
-   _mesh->mark ( s->fac() );
+   _begin_marking ();
+   _mark ( s->fac() );
 
    while ( true )
     { 
@@ -299,9 +305,9 @@ SeTriangulator::LocateResult SeTriangulator::locate_point
 
       stack.size(0);
       ccws=0;
-      _man->get_vertex_coordinates ( v1, x1, y1 );
-      _man->get_vertex_coordinates ( v2, x2, y2 );
-      _man->get_vertex_coordinates ( v3, x3, y3 );
+      man->get_vertex_coordinates ( v1, x1, y1 );
+      man->get_vertex_coordinates ( v2, x2, y2 );
+      man->get_vertex_coordinates ( v3, x3, y3 );
 
       if ( gs_ccw(x,y,x2,y2,x1,y1)>0 ) { ccws++; if(_mesh->is_triangle(s->sym())) stack.push()=s->sym(); }
       if ( gs_ccw(x,y,x3,y3,x2,y2)>0 ) { ccws++; if(_mesh->is_triangle(sn->sym())) stack.push()=sn->sym(); }
@@ -321,7 +327,7 @@ SeTriangulator::LocateResult SeTriangulator::locate_point
        { s = stack[0]; // only one option to jump to
        }
       else if ( stack.size()==2 ) // here we use marking, instead of a random choice
-       { s = _mesh->marked(stack[0]->fac())? stack[1]:stack[0];
+       { s = _marked(stack[0]->fac())? stack[1]:stack[0];
        }
       else
        { gsout.warning ("DEGENERATED CASE FOUND IN LOCATE_POINT!"); // may happen if non triangular face is found
@@ -329,7 +335,7 @@ SeTriangulator::LocateResult SeTriangulator::locate_point
          break;
        }
 
-      if ( _mesh->marked(s->fac()) ) // this may happen in CDTs, but not in DTs
+      if ( _marked(s->fac()) ) // this may happen in CDTs, but not in DTs
        { GS_TRACE1 ("Already marked triangle found - will try linear search...");
          walk_failed = true;
          break;
@@ -341,7 +347,7 @@ SeTriangulator::LocateResult SeTriangulator::locate_point
          break;
        }
 
-      _mesh->mark ( s->fac() );
+      _mark ( s->fac() );
     }
 
    GS_TRACE1 ( "Triangles Visited: " << visited_count );
@@ -352,7 +358,7 @@ SeTriangulator::LocateResult SeTriangulator::locate_point
       do { s=f->se(); sn=s->nxt(); snn=sn->nxt();
            v1=s->vtx(); v2=sn->vtx(); v3=snn->vtx(); 
            if ( snn->nxt()==s ) // is triangle
-            { if ( _man->in_triangle(v1,v2,v3,x,y) )
+            { if ( se_in_triangle(man,v1,v2,v3,x,y) )
                { result = s;
                  sres = TriangleFound;
                  break;
@@ -364,7 +370,7 @@ SeTriangulator::LocateResult SeTriangulator::locate_point
     }
 
    if ( sres==TriangleFound && loctest ) // perform extra tests
-    { sres = _man->test_boundary ( v1, v2, v3, x, y, _epsilon, _epsilonedg, s );
+    { sres = se_test_boundary ( man, v1, v2, v3, x, y, _epsilon, _epsilonedg, s );
       if ( sres==NotFound ) sres=TriangleFound;
     }
 
@@ -372,18 +378,27 @@ SeTriangulator::LocateResult SeTriangulator::locate_point
 
    if ( _debug_mode ) { if ( sres==NotFound ) gsout << "LocatePt Failed!\n"; }
 
-   _mesh->end_marking ();
+   _end_marking ();
    result = s;
 
    return (LocateResult)sres;
  }
 
+SeTriangulator::LocateResult SeTriangulator::locate_point
+                             ( const SeFace* iniface, double x, double y, SeBase*& result, bool loctest )
+ {
+   if ( _dcdtman ) return _locate_point<SeDcdtManager> ( iniface, x, y, result, loctest );
+   return _locate_point<SeTriangulatorManager> ( iniface, x, y, result, loctest );
+ }
+
 //================================================================================
 //============================== Insert Vertex ===================================
 //================================================================================
 
-SeVertex* SeTriangulator::insert_point_in_face ( SeFace* f, double x, double y )
+template <class M>
+SeVertex* SeTriangulator::_insert_point_in_face ( SeFace* f, double x, double y )
  {
+   M* man = (M*)_man;
    GS_TRACE2 ( "insert_point_in_face..." );
 
    GsArray<SeBase*>& stack = _buffer;
@@ -396,7 +411,7 @@ SeVertex* SeTriangulator::insert_point_in_face ( SeFace* f, double x, double y )
    t = _mesh->mev(s);
    SeVertex* v = t->vtx(); // this is the return vertex
    stack[0]=s;
-   _man->set_vertex_coordinates ( v, x, y );
+   man->set_vertex_coordinates ( v, x, y );
 
    s = s->nxt();
    t = _mesh->mef ( t, s );
@@ -406,14 +421,22 @@ SeVertex* SeTriangulator::insert_point_in_face ( SeFace* f, double x, double y )
    _mesh->mef ( t, s );
    stack[2]=s; 
 
-   _propagate_delaunay ();
+   _propagate_delaunay<M> ();
 
    TEST("insert_point_in_face");
    return v;
  }
 
-SeVertex* SeTriangulator::insert_point_in_edge ( SeEdge* e, double x, double y )
+SeVertex* SeTriangulator::insert_point_in_face ( SeFace* f, double x, double y )
+ {
+   if ( _dcdtman ) return _insert_point_in_face<SeDcdtManager> ( f, x, y );
+   return _insert_point_in_face<SeTriangulatorManager> ( f, x, y );
+ }
+
+template <class M>
+SeVertex* SeTriangulator::_insert_point_in_edge ( SeEdge* e, double x, double y )
  {
+   M* man = (M*)_man;
    GS_TRACE2 ( "insert_point_in_edge..." );
 
    SeBase *s = e->se();
@@ -421,8 +444,8 @@ SeVertex* SeTriangulator::insert_point_in_edge ( SeEdge* e, double x, double y )
    /* We must project into the edge to ensure correctness, otherwise we may encounter
       cases where the polygon of the neighbors of a vertex v does not contain v */
    double x1, y1, x2, y2;
-   _man->get_vertex_coordinates ( s->vtx(), x1, y1 );
-   _man->get_vertex_coordinates ( s->nxt()->vtx(), x2, y2 );
+   man->get_vertex_coordinates ( s->vtx(), x1, y1 );
+   man->get_vertex_coordinates ( s->nxt()->vtx(), x2, y2 );
 
    gs_segment_projection ( x1, y1, x2, y2, x, y, x, y, _epsilonedg );
    if ( gs_dist2(x,y,x1,y1)<=_epsilon2 ) return s->vtx();
@@ -433,7 +456,7 @@ SeVertex* SeTriangulator::insert_point_in_edge ( SeEdge* e, double x, double y )
    stack.size(4);
 
    t = _mesh->mev ( s, s->rot() );
-   _man->set_vertex_coordinates ( t->vtx(), x, y );
+   man->set_vertex_coordinates ( t->vtx(), x, y );
 
    stack[0]=s->nxt();
    stack[1]=s->nxt()->nxt();
@@ -444,32 +467,40 @@ SeVertex* SeTriangulator::insert_point_in_edge ( SeEdge* e, double x, double y )
    _mesh->mef ( t, stack[3] );
 
    if ( _mode==ModeConstrained )
-    { if ( _man->is_constrained(e) )
+    { if ( man->is_constrained(e) )
        { GS_TRACE2 ( "Point in constrained edge case..." );
          _ibuffer.size(0);
-         _man->get_constraints ( e, _ibuffer );
-         _man->add_constraints ( t->edg(), _ibuffer ); // constrain the other subdivided part
-         _man->vertex_found_in_constrained_edge ( s->vtx() );
+         man->get_constraints ( e, _ibuffer );
+         man->add_constraints ( t->edg(), _ibuffer ); // constrain the other subdivided part
+         man->vertex_found_in_constrained_edge ( s->vtx() );
        }
     }
    else if ( _mode==ModeConforming )
-    { if ( _man->is_constrained(e) )
+    { if ( man->is_constrained(e) )
        { GS_TRACE2 ( "Point in constrained edge case..." );
          GsArray<int> ids; // cannot use buffer because the insertion is recursive
-         _man->get_constraints ( e, ids );
-         _man->add_constraints ( t->edg(), ids ); // constrain the other subdivided part
-         _man->vertex_found_in_constrained_edge ( s->vtx() );
+         man->get_constraints ( e, ids );
+         man->add_constraints ( t->edg(), ids ); // constrain the other subdivided part
+         man->vertex_found_in_constrained_edge ( s->vtx() );
        }
     }
 
-   _propagate_delaunay ();
+   _propagate_delaunay<M> ();
 
    TEST("insert_point_in_edge");
    return s->vtx();
  }
 
+SeVertex* SeTriangulator::insert_point_in_edge ( SeEdge* e, double x, double y )
+ {
+   if ( _dcdtman ) return _insert_point_in_edge<SeDcdtManager> ( e, x, y );
+   return _insert_point_in_edge<SeTriangulatorManager> ( e, x, y );
+ }
+
+template <class M>
 void SeTriangulator::_propagate_delaunay ()
  {
+   M* man = (M*)_man;
    GS_TRACE2 ( "propagate_delaunay..." );
 
    SeBase *s, *x, *t;
@@ -481,9 +512,9 @@ void SeTriangulator::_propagate_delaunay ()
 
       while ( stack.size()>0 )
        { x = stack.pop();
-         if ( !_man->is_delaunay(x->edg()) )  // Flip will optimize triang
+         if ( !se_is_delaunay(man,x->edg()) )  // Flip will optimize triang
           { s=x->sym()->pri(); t=s->nxt()->nxt();
-            if ( !_man->is_constrained(x->edg()) )
+            if ( !man->is_constrained(x->edg()) )
              { _mesh->flip(x); stack.push(s); stack.push(t); }
           }
        }
@@ -497,7 +528,7 @@ void SeTriangulator::_propagate_delaunay ()
        { x = stack.pop();
          // remember that in the delaunay case edges are always flippable;
          // originating from a star polygon
-         if ( !_man->is_delaunay(x->edg()) )  // Flip will optimize triang
+         if ( !se_is_delaunay(man,x->edg()) )  // Flip will optimize triang
           { s=x->sym()->pri(); t=s->nxt()->nxt();
             _mesh->flip(x); stack.push(s); stack.push(t);
           }
@@ -515,15 +546,15 @@ void SeTriangulator::_propagate_delaunay ()
 
       while ( stack.size()>0 )
        { x = stack.pop();
-         if ( !_man->is_delaunay(x->edg()) )  // Flip will optimize triang
+         if ( !se_is_delaunay(man,x->edg()) )  // Flip will optimize triang
           { s=x->sym()->pri(); t=s->nxt()->nxt();
-            if ( _man->is_constrained(x->edg()) )
+            if ( man->is_constrained(x->edg()) )
              { GS_TRACE2 ( "Prepare to flip constrained edge..." );
                constraints_ids.push() = new GsArray<int>;
-               _man->get_constraints ( x->edg(), *constraints_ids.top() );
+               man->get_constraints ( x->edg(), *constraints_ids.top() );
                constraints.push() = x->vtx();
                constraints.push() = x->nxt()->vtx();
-               _man->set_unconstrained ( x->edg() );
+               man->set_unconstrained ( x->edg() );
              }
             _mesh->flip(x); stack.push(s); stack.push(t);
           }
@@ -586,7 +617,10 @@ bool SeTriangulator::insert_line_constraint ( SeVertex *v1, SeVertex *v2, int id
    if ( v1==v2 ) return true;
    bool res = false;
    switch ( _mode )
-    { case ModeConstrained: res=_constrain_line ( v1, v2, ids ); break;
+    { case ModeConstrained:
+        res = _dcdtman? _constrain_line<SeDcdtManager> ( v1, v2, ids )
+                      : _constrain_line<SeTriangulatorManager> ( v1, v2, ids );
+        break;
       case ModeConforming: res=_conform_line ( v1, v2, ids ); break;
       default: return false; // case ModeUnconstrained
     }
@@ -691,9 +725,11 @@ bool SeTriangulator::_conform_line ( SeVertex *v1, SeVertex *v2,
 
 // handle ok if v1-v2 is already there
 // To check: constrain_line doesnt seem to need to receive an array of indices.
+template <class M>
 bool SeTriangulator::_constrain_line ( SeVertex* v1, SeVertex* v2,
                                        const GsArray<int>& constraints_ids )
  {
+   M* man = (M*)_man;
    GsArray<SeBase*>& totrig = _buffer;
    GsArray<ConstrElem>& ea = _elembuffer;
    SeBase *s, *e, *s1, *s2 = 0;
@@ -714,17 +750,17 @@ bool SeTriangulator::_constrain_line ( SeVertex* v1, SeVertex* v2,
    while ( v!=v2 )
     { //SeBase* ssave=s;
       //SeVertex* vsave=v;
-      if ( v ) _v_next_step ( s, v1, v2, v, e );
-        else   _e_next_step ( s, v1, v2, v, e );
+      if ( v ) _v_next_step<M> ( s, v1, v2, v, e );
+        else   _e_next_step<M> ( s, v1, v2, v, e );
 
-      if ( e && _man->is_constrained(e->edg()) ) // intersects with another constrained edge
+      if ( e && man->is_constrained(e->edg()) ) // intersects with another constrained edge
        { 
-         _man->segments_intersect ( v1, v2, e->vtx(), e->nxt()->vtx(), px, py );
+         se_segments_intersect ( man, v1, v2, e->vtx(), e->nxt()->vtx(), px, py );
          s = _mesh->mev ( e, e->rot() );
          v = s->vtx();
-         _man->set_vertex_coordinates ( v, px, py );
-         _man->new_intersection_vertex_created ( v );
-         _man->copy_constraints ( e->edg(), s->edg() );
+         man->set_vertex_coordinates ( v, px, py );
+         man->new_intersection_vertex_created ( v );
+         man->copy_constraints ( e->edg(), s->edg() );
          e=0; 
          _mesh->mef ( s, s->nxn() ); s=s->sym();
          _mesh->mef ( s->nxt(), s->pri() );
@@ -743,12 +779,12 @@ bool SeTriangulator::_constrain_line ( SeVertex* v1, SeVertex* v2,
          GS_TRACE3 ( (v==v2?"Found vertex v2.":"Crossed existing vertex.") );
          if ( v!=v2 ) // project point to line for perfect placement
           { double x1, y1, x2, y2;
-            _man->get_vertex_coordinates ( v1, x1, y1 );
-            _man->get_vertex_coordinates ( v2, x2, y2 );
-            _man->get_vertex_coordinates ( v, px, py );
+            man->get_vertex_coordinates ( v1, x1, y1 );
+            man->get_vertex_coordinates ( v2, x2, y2 );
+            man->get_vertex_coordinates ( v, px, py );
             gs_line_projection ( x1, y1, x2, y2, px, py, px, py );
-            _man->set_vertex_coordinates ( v, px, py );
-            _man->vertex_found_in_constrained_edge(v);
+            man->set_vertex_coordinates ( v, px, py );
+            man->vertex_found_in_constrained_edge(v);
           }
          v1=v; // advance v1
        }
@@ -769,7 +805,7 @@ bool SeTriangulator::_constrain_line ( SeVertex* v1, SeVertex* v2,
           { GS_TRACE3 ( "Constraining existing edge..." );
             s = ea[iv1].v->se();
             while ( s->nxt()->vtx()!=ea[iv2].v ) s=s->rot();
-            _man->add_constraints(s->edg(),constraints_ids);
+            man->add_constraints(s->edg(),constraints_ids);
           }
          else // kill inbetween edges and put new constraint there
           { // here is where we could implement Bernal flips
@@ -778,7 +814,7 @@ bool SeTriangulator::_constrain_line ( SeVertex* v1, SeVertex* v2,
             for ( j=iv1+1; j<iv2; j++ ) s2=_mesh->kef(ea[j].e,&s);
             GS_TRACE3 ( "Adding edge constraint..." );
             s = _mesh->mef ( s1, s2->nxt() );
-            _man->add_constraints(s->edg(),constraints_ids);
+            man->add_constraints(s->edg(),constraints_ids);
             totrig.push() = s;        // face to be re-triangulated later
             totrig.push() = s->sym(); // face to be re-triangulated later
           }
@@ -794,11 +830,11 @@ bool SeTriangulator::_constrain_line ( SeVertex* v1, SeVertex* v2,
       s1 = s2->nxt()->nxt();
       if ( s1->nxt()==s2 ) continue; // already a triangle
 
-      _man->get_vertex_coordinates ( s2->vtx(), x2, y2 );
-      _man->get_vertex_coordinates ( s2->nxt()->vtx(), x2n, y2n );
+      man->get_vertex_coordinates ( s2->vtx(), x2, y2 );
+      man->get_vertex_coordinates ( s2->nxt()->vtx(), x2n, y2n );
 
       for ( s=s1; s!=s2; s=s->nxt() )
-       { if ( _canconnect(s2,s,x2,y2,x2n,y2n) )
+       { if ( _canconnect<M>(s2,s,x2,y2,x2n,y2n) )
           { _maketri ( totrig, s2, s1, s );
             break;
           }
@@ -814,9 +850,11 @@ bool SeTriangulator::_constrain_line ( SeVertex* v1, SeVertex* v2,
    return true;
  }
 
+template <class M>
 void SeTriangulator::_v_next_step ( SeBase* s, SeVertex* v1, SeVertex* v2,
                                     SeVertex*& v, SeBase*& e )
  {
+   M* man = (M*)_man;
    e=0;
    double x1, y1, x2, y2, x3, y3, x4, y4, d2, t;
 
@@ -826,26 +864,26 @@ void SeTriangulator::_v_next_step ( SeBase* s, SeVertex* v1, SeVertex* v2,
         x=x->rot();
       } while ( x!=s );
 
-   _man->get_vertex_coordinates ( v1, x1, y1 );
-   _man->get_vertex_coordinates ( v2, x2, y2 );
+   man->get_vertex_coordinates ( v1, x1, y1 );
+   man->get_vertex_coordinates ( v2, x2, y2 );
    
    // Project current vertex in the line to get perfect placement
    // and then only consider intersections in the subsegment (v,v2)
    // (cases where v1 was an existing vertex within epsilon distance to the line)
    if ( v!=v1 )
-    { _man->get_vertex_coordinates ( v, x3, y3 );
+    { man->get_vertex_coordinates ( v, x3, y3 );
       gs_line_projection ( x1, y1, x2, y2, x3, y3, x1, y1 );
     }
 
    // Now test the first neighbor vertex:
    v = x->nxt()->vtx();
-   _man->get_vertex_coordinates ( v, x3, y3 );
+   man->get_vertex_coordinates ( v, x3, y3 );
    bool inseg=gs_in_segment(x1,y1,x2,y2,x3,y3,_epsilonedg,d2,t);
    if ( inseg && t>=0 ) return;
 
    // Then look for intersections in all neighbors:
    do { v = x->nxt()->nxt()->vtx();
-        _man->get_vertex_coordinates ( v, x4, y4 );
+        man->get_vertex_coordinates ( v, x4, y4 );
         bool inseg=gs_in_segment(x1,y1,x2,y2,x4,y4,_epsilonedg,d2,t);
         if ( inseg && t>=0 ) return;
         if ( gs_segments_intersect(x1,y1,x2,y2,x3,y3,x4,y4) ) { v=0; e=x->nxt(); return; }
@@ -858,9 +896,11 @@ void SeTriangulator::_v_next_step ( SeBase* s, SeVertex* v1, SeVertex* v2,
    gsout.fatal( "se_triangulator.cpp: error in v_next_step()!\n" );
  }
 
+template <class M>
 void SeTriangulator::_e_next_step ( SeBase* s, SeVertex* v1, SeVertex* v2,
                                                SeVertex*& v, SeBase*& e )
  {
+   M* man = (M*)_man;
    v=0;
    e=0;
    SeVertex *va, *vb;
@@ -870,25 +910,27 @@ void SeTriangulator::_e_next_step ( SeBase* s, SeVertex* v1, SeVertex* v2,
    if ( vb==v2 ) { v=v2; return; }
 
    double x1, y1, x2, y2, x3, y3, x4, y4;
-   _man->get_vertex_coordinates ( v1, x1, y1 );
-   _man->get_vertex_coordinates ( v2, x2, y2 );
-   _man->get_vertex_coordinates ( va, x3, y3 );
-   _man->get_vertex_coordinates ( vb, x4, y4 );
+   man->get_vertex_coordinates ( v1, x1, y1 );
+   man->get_vertex_coordinates ( v2, x2, y2 );
+   man->get_vertex_coordinates ( va, x3, y3 );
+   man->get_vertex_coordinates ( vb, x4, y4 );
 
    if ( gs_in_segment(x1,y1,x2,y2,x4,y4,_epsilonedg) ) { v=vb; return; }
 
    e = gs_segments_intersect(x1,y1,x2,y2,x3,y3,x4,y4)? s->nxt() : s->nxt()->nxt();
  }
 
+template <class M>
 bool SeTriangulator::_canconnect ( SeBase* s2, SeBase* sv, double x2, double y2, double x2n, double y2n )
  {
+   M* man = (M*)_man;
    double xv, yv, x, y;
-   _man->get_vertex_coordinates ( sv->vtx(), xv, yv );
+   man->get_vertex_coordinates ( sv->vtx(), xv, yv );
 
    SeBase* s;
    for ( s=s2->nxt()->nxt(); s!=s2; s=s->nxt() )
     { if ( s==sv ) continue;
-      _man->get_vertex_coordinates ( s->vtx(), x, y );
+      man->get_vertex_coordinates ( s->vtx(), x, y );
       if ( gs_in_circle(x2,y2,x2n,y2n,xv,yv,x,y) ) return false;
     }
    
@@ -916,8 +958,10 @@ void SeTriangulator::_maketri ( GsArray<SeBase*>& totrig, SeBase* s2, SeBase* s1
 //============================== refine edges ====================================
 //================================================================================
 
-int SeTriangulator::refine_edges ( float targetlen, bool markvref )
+template <class M>
+int SeTriangulator::_refine_edges ( float targetlen, bool markvref )
  {
+   M* man = (M*)_man;
    SeVertex* v;
    SeEdge* e;
    SeEdge* ei;
@@ -935,10 +979,10 @@ int SeTriangulator::refine_edges ( float targetlen, bool markvref )
    while ( true )
     { // collect all edges longer than targetlen:
       ei = e = _mesh->first()->edg();
-      do { if ( _man->is_constrained(e) )
+      do { if ( man->is_constrained(e) )
             { se = e->se();
-              _man->get_vertex_coordinates ( se->vtx(), x1, y1 );
-              _man->get_vertex_coordinates ( se->nvtx(), x2, y2 );
+              man->get_vertex_coordinates ( se->vtx(), x1, y1 );
+              man->get_vertex_coordinates ( se->nvtx(), x2, y2 );
               len2 = gs_dist2 ( x1, y1, x2, y2 );
               if ( len2>tlen2 ) _buffer.push()=se;
             }
@@ -951,11 +995,11 @@ int SeTriangulator::refine_edges ( float targetlen, bool markvref )
       // subdivide all edges:
       while ( _buffer.size()>0 )
        { se = _buffer.pop();
-         _man->get_vertex_coordinates ( se->vtx(), x1, y1 );
-         _man->get_vertex_coordinates ( se->nvtx(), x2, y2 );
-         v = insert_point_in_edge ( se->edg(), (x1+x2)/2.0, (y1+y2)/2.0 );
+         man->get_vertex_coordinates ( se->vtx(), x1, y1 );
+         man->get_vertex_coordinates ( se->nvtx(), x2, y2 );
+         v = _insert_point_in_edge<M> ( se->edg(), (x1+x2)/2.0, (y1+y2)/2.0 );
          if ( !v ) { gsout.warning("Insertion failure in refine_edges()!"); count--; }
-          else if ( markvref ) { _man->new_steiner_vertex_created(v); }
+          else if ( markvref ) { man->new_steiner_vertex_created(v); }
        }
       count += _buffer.size();
     }
@@ -963,5 +1007,11 @@ int SeTriangulator::refine_edges ( float targetlen, bool markvref )
    return count;
  }
 
+int SeTriangulator::refine_edges ( float targetlen, bool markvref )
+ {
+   if ( _dcdtman ) return _refine_edges<SeDcdtManager> ( targetlen, markvref );
+   return _refine_edges<SeTriangulatorManager> ( targetlen, markvref );
+ }
+
 //============================ End of File =================================
 
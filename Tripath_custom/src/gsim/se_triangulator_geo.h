@@ -0,0 +1,131 @@
+/*=======================================================================
+   Copyright 2010 Marcelo Kallmann. All Rights Reserved.
+   This software is distributed for noncommercial use only, without
+   any warranties, and provided that all copies contain the full copyright
+   notice licence.txt located at the base folder of the distribution. 
+  =======================================================================*/
+
+//=== internal header file ===//
+
+/* Geometric tests of SeTriangulatorManager written for a manager class M, which reads
+   the vertex coordinates with M::get_vertex_coordinates(). SeTriangulatorManager uses
+   them with itself, and the triangulator also with SeDcdtManager, whose coordinates
+   are then read inline. */
+
+# include <gsim/gs_geo2.h>
+# include <gsim/se_triangulator.h>
+
+template <class M>
+inline bool se_in_triangle ( M* man, SeVertex* v1, SeVertex* v2, SeVertex* v3, double x, double y )
+ {
+   double x1, y1, x2, y2, x3, y3;
+   man->get_vertex_coordinates ( v1, x1, y1 );
+   man->get_vertex_coordinates ( v2, x2, y2 );
+   man->get_vertex_coordinates ( v3, x3, y3 );
+   return gs_in_triangle ( x1, y1, x2, y2, x3, y3, x, y );
+ }
+
+template <class M>
+inline bool se_is_delaunay ( M* man, SeEdge* e )
+ {
+   SeBase* s1 = e->se();
+   SeBase* s2 = s1->sym();
+   SeBase* s3 = s2->nxt()->nxt();
+   SeBase* s4 = s1->nxt()->nxt();
+
+   double x1, y1, x2, y2, x3, y3, x4, y4;
+   man->get_vertex_coordinates ( s1->vtx(), x1, y1 );
+   man->get_vertex_coordinates ( s2->vtx(), x2, y2 );
+   man->get_vertex_coordinates ( s3->vtx(), x3, y3 );
+   man->get_vertex_coordinates ( s4->vtx(), x4, y4 );
+
+   return gs_in_circle ( x1, y1, x2, y2, x4, y4, x3, y3 )? false:true;
+ }
+
+template <class M>
+inline bool se_segments_intersect ( M* man, SeVertex* v1, SeVertex* v2, SeVertex* v3, SeVertex* v4, double& x, double& y )
+ {
+   double x1, y1, x2, y2, x3, y3, x4, y4;
+   man->get_vertex_coordinates ( v1, x1, y1 );
+   man->get_vertex_coordinates ( v2, x2, y2 );
+   man->get_vertex_coordinates ( v3, x3, y3 );
+   man->get_vertex_coordinates ( v4, x4, y4 );
+   return gs_segments_intersect ( x1, y1, x2, y2, x3, y3, x4, y4, x, y );
+ }
+
+// a more efficient implementation would use marking instead of the many CCW tests
+template <class M>
+bool se_sector_vfree ( M* man, SeBase* s, double r2, double cx, double cy,
+                       double x1, double y1, double x2, double y2, SeBase*& sv )
+ {
+   double t, d2, x3, y3;
+
+   // check if s is distant enought from c:
+   d2 = gs_point_segment_dist2(cx,cy,x1,y1,x2,y2,t);
+   if ( d2>=r2 ) return true; // ok enought space
+
+   // test if we're too close to a vertex:
+   if ( gs_next2(cx,cy,x1,y1,r2) ) {sv=s; return false;}
+   if ( gs_next2(cx,cy,x2,y2,r2) ) {sv=s->nxt(); return false; }
+
+   // recurse if border not reached:
+   s=s->sym()->nxt();
+   if ( s->nxt()->nxn()!=s ) return true; // attention: this border test assumes non-triangular backface
+
+   man->get_vertex_coordinates ( s->nvtx(), x3, y3 );
+   if ( gs_ccw(cx,cy,x3,y3,x2,y2)>0 ) // c-p3-p2
+    { 
+      if ( !se_sector_vfree(man,s->nxt(),r2,cx,cy,x3,y3,x2,y2,sv) ) return false;
+    }
+   if ( gs_ccw(cx,cy,x1,y1,x3,y3)>0 ) // c-p1-p3
+    { 
+      if ( !se_sector_vfree(man,s,r2,cx,cy,x1,y1,x3,y3,sv) ) return false;
+    }
+
+   return true;
+ }
+
+// attention: s must be well positioned
+template <class M>
+int se_test_boundary ( M* man, SeVertex* v1, SeVertex* v2, SeVertex* v3,
+                       double x, double y, double eps, double epsedg, SeBase*& s )
+ {
+   double x1, y1, x2, y2, x3, y3, eps2=eps*eps;
+   man->get_vertex_coordinates ( v1, x1, y1 );
+   man->get_vertex_coordinates ( v2, x2, y2 );
+   man->get_vertex_coordinates ( v3, x3, y3 );
+
+   if ( epsedg<eps ) // this is for the agent placement test experiments:
+    { SeBase* sn = s->nxt();
+      SeBase* sp = sn->nxt();
+      if ( !se_sector_vfree(man,s,eps2,x,y,x1,y1,x2,y2,s) ) return SeTriangulator::VertexFound;
+      if ( !se_sector_vfree(man,sn,eps2,x,y,x2,y2,x3,y3,s) ) return SeTriangulator::VertexFound;
+      if ( !se_sector_vfree(man,sp,eps2,x,y,x3,y3,x1,y1,s) ) return SeTriangulator::VertexFound;
+      if ( gs_in_segment(x1,y1,x2,y2,x,y,epsedg) ) { return SeTriangulator::EdgeFound; }
+      if ( gs_in_segment(x2,y2,x3,y3,x,y,epsedg) ) { s=sn; return SeTriangulator::EdgeFound; }
+      if ( gs_in_segment(x3,y3,x1,y1,x,y,epsedg) ) { s=sp; return SeTriangulator::EdgeFound; }
+    }
+   else // we can do only 5 tests:
+    { if ( gs_in_segment(x1,y1,x2,y2,x,y,epsedg) )
+       { if ( gs_next2(x1,y1,x,y,eps2) ) { return SeTriangulator::VertexFound; }
+         if ( gs_next2(x2,y2,x,y,eps2) ) { s=s->nxt(); return SeTriangulator::VertexFound; }
+         return SeTriangulator::EdgeFound;
+       }
+      if ( gs_in_segment(x2,y2,x3,y3,x,y,epsedg) )
+       { s=s->nxt();
+         if ( gs_next2(x2,y2,x,y,eps2) ) { return SeTriangulator::VertexFound; }
+         if ( gs_next2(x3,y3,x,y,eps2) ) { s=s->nxt(); return SeTriangulator::VertexFound; }
+         return SeTriangulator::EdgeFound;
+       }
+      if ( gs_in_segment(x3,y3,x1,y1,x,y,epsedg) )
+       { s=s->nxt()->nxt();
+         if ( gs_next2(x3,y3,x,y,eps2) ) { return SeTriangulator::VertexFound; }
+         if ( gs_next2(x1,y1,x,y,eps2) ) { s=s->nxt(); return SeTriangulator::VertexFound; }
+         return SeTriangulator::EdgeFound;
+       }
+    }
+
+   return SeTriangulator::NotFound;
+ }
+
+//============================ End of File =================================
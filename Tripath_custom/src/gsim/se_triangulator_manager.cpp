@@ -12,6 +12,7 @@
 
 # include <gsim/se_triangulator_manager.h>
 # include <gsim/se_triangulator.h>
+# include "se_triangulator_geo.h"
 
 //# define GS_USE_TRACE1 // not yet used
 # include <gsim/gs_trace.h>
@@ -107,11 +108,7 @@ bool SeTriangulatorManager::in_triangle ( SeVertex* v1, SeVertex* v2, SeVertex*
 bool SeTriangulatorManager::in_triangle ( SeVertex* v1, SeVertex* v2, SeVertex* v3,
                                           double x, double y )
  {
-   double x1, y1, x2, y2, x3, y3;
-   get_vertex_coordinates ( v1, x1, y1 );
-   get_vertex_coordinates ( v2, x2, y2 );
-   get_vertex_coordinates ( v3, x3, y3 );
-   return gs_in_triangle ( x1, y1, x2, y2, x3, y3, x, y );
+   return se_in_triangle ( this, v1, v2, v3, x, y );
  }
 
 bool SeTriangulatorManager::in_segment ( SeVertex* v1, SeVertex* v2, SeVertex* v, double eps )
@@ -125,18 +122,7 @@ bool SeTriangulatorManager::in_segment ( SeVertex* v1, SeVertex* v2, SeVertex* v
 
 bool SeTriangulatorManager::is_delaunay ( SeEdge* e )
  {
-   SeBase* s1 = e->se();
-   SeBase* s2 = s1->sym();
-   SeBase* s3 = s2->nxt()->nxt();
-   SeBase* s4 = s1->nxt()->nxt();
-
-   double x1, y1, x2, y2, x3, y3, x4, y4;
-   get_vertex_coordinates ( s1->vtx(), x1, y1 );
-   get_vertex_coordinates ( s2->vtx(), x2, y2 );
-   get_vertex_coordinates ( s3->vtx(), x3, y3 );
-   get_vertex_coordinates ( s4->vtx(), x4, y4 );
-
-   return gs_in_circle ( x1, y1, x2, y2, x4, y4, x3, y3 )? false:true;
+   return se_is_delaunay ( this, e );
  }
 
 bool SeTriangulatorManager::is_flippable_and_not_delaunay ( SeEdge* e )
@@ -159,89 +145,23 @@ bool SeTriangulatorManager::is_flippable_and_not_delaunay ( SeEdge* e )
    return gs_in_circle ( x1, y1, x2, y2, x4, y4, x3, y3 );
  }
 
-// a more efficient implementation would use marking instead of the many CCW tests
 bool SeTriangulatorManager::sector_vfree ( SeBase* s, double r2, double cx, double cy,
                             double x1, double y1, double x2, double y2, SeBase*& sv )
  {
-   double t, d2, x3, y3;
-
-   // check if s is distant enought from c:
-   d2 = gs_point_segment_dist2(cx,cy,x1,y1,x2,y2,t);
-   if ( d2>=r2 ) return true; // ok enought space
-
-   // test if we're too close to a vertex:
-   if ( gs_next2(cx,cy,x1,y1,r2) ) {sv=s; return false;}
-   if ( gs_next2(cx,cy,x2,y2,r2) ) {sv=s->nxt(); return false; }
-
-   // recurse if border not reached:
-   s=s->sym()->nxt();
-   if ( s->nxt()->nxn()!=s ) return true; // attention: this border test assumes non-triangular backface
-
-   get_vertex_coordinates ( s->nvtx(), x3, y3 );
-   if ( gs_ccw(cx,cy,x3,y3,x2,y2)>0 ) // c-p3-p2
-    { 
-      if ( !sector_vfree(s->nxt(),r2,cx,cy,x3,y3,x2,y2,sv) ) return false;
-    }
-   if ( gs_ccw(cx,cy,x1,y1,x3,y3)>0 ) // c-p1-p3
-    { 
-      if ( !sector_vfree(s,r2,cx,cy,x1,y1,x3,y3,sv) ) return false;
-    }
-
-   return true;
+   return se_sector_vfree ( this, s, r2, cx, cy, x1, y1, x2, y2, sv );
  }
 
-// attention: s must be well positioned
 int SeTriangulatorManager::test_boundary ( SeVertex* v1, SeVertex* v2, SeVertex* v3,
                                            double x, double y, double eps, double epsedg, SeBase*& s )
  {
-   double x1, y1, x2, y2, x3, y3, eps2=eps*eps;
-   get_vertex_coordinates ( v1, x1, y1 );
-   get_vertex_coordinates ( v2, x2, y2 );
-   get_vertex_coordinates ( v3, x3, y3 );
-
-   if ( epsedg<eps ) // this is for the agent placement test experiments:
-    { SeBase* sn = s->nxt();
-      SeBase* sp = sn->nxt();
-      if ( !sector_vfree(s,eps2,x,y,x1,y1,x2,y2,s) ) return SeTriangulator::VertexFound;
-      if ( !sector_vfree(sn,eps2,x,y,x2,y2,x3,y3,s) ) return SeTriangulator::VertexFound;
-      if ( !sector_vfree(sp,eps2,x,y,x3,y3,x1,y1,s) ) return SeTriangulator::VertexFound;
-      if ( gs_in_segment(x1,y1,x2,y2,x,y,epsedg) ) { return SeTriangulator::EdgeFound; }
-      if ( gs_in_segment(x2,y2,x3,y3,x,y,epsedg) ) { s=sn; return SeTriangulator::EdgeFound; }
-      if ( gs_in_segment(x3,y3,x1,y1,x,y,epsedg) ) { s=sp; return SeTriangulator::EdgeFound; }
-    }
-   else // we can do only 5 tests:
-    { if ( gs_in_segment(x1,y1,x2,y2,x,y,epsedg) )
-       { if ( gs_next2(x1,y1,x,y,eps2) ) { return SeTriangulator::VertexFound; }
-         if ( gs_next2(x2,y2,x,y,eps2) ) { s=s->nxt(); return SeTriangulator::VertexFound; }
-         return SeTriangulator::EdgeFound;
-       }
-      if ( gs_in_segment(x2,y2,x3,y3,x,y,epsedg) )
-       { s=s->nxt();
-         if ( gs_next2(x2,y2,x,y,eps2) ) { return SeTriangulator::VertexFound; }
-         if ( gs_next2(x3,y3,x,y,eps2) ) { s=s->nxt(); return SeTriangulator::VertexFound; }
-         return SeTriangulator::EdgeFound;
-       }
-      if ( gs_in_segment(x3,y3,x1,y1,x,y,epsedg) )
-       { s=s->nxt()->nxt();
-         if ( gs_next2(x3,y3,x,y,eps2) ) { return SeTriangulator::VertexFound; }
-         if ( gs_next2(x1,y1,x,y,eps2) ) { s=s->nxt(); return SeTriangulator::VertexFound; }
-         return SeTriangulator::EdgeFound;
-       }
-    }
-
-   return SeTriangulator::NotFound;
+   return se_test_boundary ( this, v1, v2, v3, x, y, eps, epsedg, s );
  }
 
 bool SeTriangulatorManager::segments_intersect ( SeVertex* v1, SeVertex* v2, 
                                                  SeVertex* v3, SeVertex* v4,
                                                  double& x, double& y )
  {
-   double x1, y1, x2, y2, x3, y3, x4, y4;
-   get_vertex_coordinates ( v1, x1, y1 );
-   get_vertex_coordinates ( v2, x2, y2 );
-   get_vertex_coordinates ( v3, x3, y3 );
-   get_vertex_coordinates ( v4, x4, y4 );
-   return gs_segments_intersect ( x1, y1, x2, y2, x3, y3, x4, y4, x, y );
+   return se_segments_intersect ( this, v1, v2, v3, v4, x, y );
  }
 
 bool SeTriangulatorManager::segments_intersect ( SeVertex* v1, SeVertex* v2, 
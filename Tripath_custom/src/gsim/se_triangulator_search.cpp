@@ -210,7 +210,7 @@ void SeTriangulator::_trytoadd ( SeBase* s, int mi, PathNode* n, double x1, doub
     // if ( sym->nxt()->nxt()->nxt()!=sym ) return;
 
 	// test if the next triangle is already visited:
-    if ( _mesh->marked(sym->fac()) ) return;
+    if ( _marked(sym->fac()) ) return;
 
    double xn, yn, x, y; float ncost;
 
@@ -236,7 +236,7 @@ void SeTriangulator::_ptree_init ( SeTriangulator::LocateResult res, SeBase* s,
    _ptree->init ( r );
    int mi = res==EdgeFound? -2:-1;
    GS_TRACE1 ( "Initializing from " <<((const char*)mi==-1?"face":"edge")<<"..." );
-   _mesh->mark ( s->fac() );
+   _mark ( s->fac() );
    _trytoadd ( s, mi ); mi=-1;
    s = s->nxt();
    _trytoadd ( s, mi );
@@ -269,7 +269,7 @@ int SeTriangulator::_expand_lowest_cost_leaf ()
       return min_i; // FOUND!
     }
 
-   _mesh->mark ( s->fac() );
+   _mark ( s->fac() );
 
    s = s->nxt();
    _trytoadd ( s, min_i, &_ptree->nodes[min_i], x1, y1, x3, y3 );
@@ -315,7 +315,7 @@ bool SeTriangulator::search_channel ( double x1, double y1, double x2, double y2
 
    GS_TRACE1 ( "Initializing A* search..." );
 
-   _mesh->begin_marking ();
+   _begin_marking ();
    _ptree_init ( res, s );
 
    GS_TRACE1 ( "Expanding leafs..." );
@@ -323,7 +323,7 @@ bool SeTriangulator::search_channel ( double x1, double y1, double x2, double y2
    while ( found==ExpansionNotFinished )
     found = _expand_lowest_cost_leaf();
 
-   _mesh->end_marking ();
+   _end_marking ();
 
    if ( found==ExpansionBlocked )
     { GS_TRACE1 ( "Points are not connectable!" );
@@ -1,18 +1,20 @@
 # include <stdlib.h>
 # include <gsim/se_lct.h>
+# include <gsim/se_lct_batch.h>
+# include <gsim/se_lct_cache.h>
 # include <math.h>
 # include <time.h>
 # include <string>
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <vector>
 
-# ifdef SETUT_FLGLUT
-# include <gsim/gs_ogl.h>
-# include "setut_flglut.h"
-# else
-# include <GL/glut.h>
-#endif
+# ifdef GS_WINDOWS
+# include <io.h>
+# include <fcntl.h>
+# endif
 
 // *******************************************************************************
 // DEFINE TEST EXAMPLE 
@@ -59,759 +61,166 @@ static void create_lct( SeLct *TheLct )
     }
 }
 
-static int insert_polygon_from_array( SeLct *TheLct, float *x0, float *y0, int n0 )
+// directory of the map files, set by uxas_map_dir()
+static std::string MapDir = "../maps/";
+
+/* Sets the directory of the map files to maps/ next to the bin/ directory of the
+   given executable path, or to the SETUT_MAPS environment variable if defined. */
+void uxas_map_dir(std::string exe)
 {
-    int k;
-    GsPolygon pol;
-    
-    int polygonID;
-    
-    pol.size(0);
-    for(k=0;k<n0;k++)
+    const char* env = getenv("SETUT_MAPS");
+    if( env )
     {
-        pol.push().set( (float)x0[k], (float)y0[k] );
+        MapDir = env;
+        if( !MapDir.empty() && MapDir[MapDir.size()-1]!='/' ) MapDir += "/";
+        return;
     }
-    polygonID = TheLct->insert_polygon( pol );
-    
-    return polygonID;
+    size_t k = exe.find_last_of('/');
+    MapDir = ( k==std::string::npos? std::string() : exe.substr(0,k+1) ) + "../maps/";
 }
 
+/* Maps are SeDcdt files (see SeDcdt::load) with the domain of the map and each of
+   its no-fly zone configurations as a variant, selected by nfz. A map given by name
+   is read from <MapDir>/<name>.dcdt; a name containing '/' or '.' is used as the
+   path of the file. Files ending in .lct are snapshots saved by uxas_snapshot(), which
+   are loaded already refined (nfz is then not used). If the file cannot be read only
+   the default domain is built. */
 static void create_lct_example1(SeLct *TheLct, std::string map, int nfz)
 {
-    int k;
-    GsPolygon pol;
+    std::cerr << "Map name:  " << map << "\n";
+    std::cerr << "No-fly zone:  " << nfz << "\n";    
 
-    //Establish the map boundaries (large enough to work for all map types)
-    int n0 = 4; 
-    float x0[n0], y0[n0];        
-    x0[0] = -10500.0;  y0[0] = -10500.0;
-    x0[1] = -10500.0;  y0[1] = 10500.0;
-    x0[2] = 10500.0;   y0[2] = 10500.0;
-    x0[3] = 10500.0;  y0[3] = -10500.0;    
-    pol.size(0);
-    for(k=0;k<n0;k++)
+    std::string file = map.find_first_of("/.")==std::string::npos? MapDir+map+".dcdt" : map;
+    size_t n = file.size();
+    if( n>4 && file.compare(n-4,4,".lct")==0 )
     {
-        pol.push().set( (float)x0[k], (float)y0[k] );
+        if( TheLct->load_snapshot( file.c_str() ) ) return;
+    }
+    else
+    {
+        GsInput inp;
+        if( inp.open( file.c_str() ) && TheLct->load( inp, nfz ) ) return;
     }
-    TheLct->init(pol,0.00001f);
-    
-    
-    //Establish the NFZ(s) for each map
-    std::cout << "Map name:  " << map << "\n";
-    std::cout << "No-fly zone:  " << nfz << "\n";    
-    int polyID;    
-    
-    //RANDOM MAP
-    if ( map == "random"){
-        if ( nfz == 1){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = -500;      y1[0] = 2000;
-            x1[1] = 500;      y1[1] = 2000;
-            x1[2] = 500;    y1[2] = -2000;
-            x1[3] = -500;    y1[3] = -2000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 2){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = -500;      y1[0] = 2500;
-            x1[1] = 500;      y1[1] = 2500;
-            x1[2] = 500;    y1[2] = -2500;
-            x1[3] = -500;    y1[3] = -2500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 3){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = -500;      y1[0] = 3000;
-            x1[1] = 500;      y1[1] = 3000;
-            x1[2] = 500;    y1[2] = -3000;
-            x1[3] = -500;    y1[3] = -3000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 4){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = -500;      y1[0] = 3500;
-            x1[1] = 500;      y1[1] = 3500;
-            x1[2] = 500;    y1[2] = -3500;
-            x1[3] = -500;    y1[3] = -3500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 5){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = -500;      y1[0] = 4000;
-            x1[1] = 500;      y1[1] = 4000;
-            x1[2] = 500;    y1[2] = -4000;
-            x1[3] = -500;    y1[3] = -4000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 6){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = -500;      y1[0] = 4500;
-            x1[1] = 500;      y1[1] = 4500;
-            x1[2] = 500;    y1[2] = -4500;
-            x1[3] = -500;    y1[3] = -4500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 7){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = -500;      y1[0] = 5000;
-            x1[1] = 500;      y1[1] = 5000;
-            x1[2] = 500;    y1[2] = -5000;
-            x1[3] = -500;    y1[3] = -5000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 8){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = -500;      y1[0] = 5500;
-            x1[1] = 500;      y1[1] = 5500;
-            x1[2] = 500;    y1[2] = -5500;
-            x1[3] = -500;    y1[3] = -5500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 9){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = -500;      y1[0] = 6000;
-            x1[1] = 500;      y1[1] = 6000;
-            x1[2] = 500;    y1[2] = -6000;
-            x1[3] = -500;    y1[3] = -6000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 10){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = -500;      y1[0] = 6500;
-            x1[1] = 500;      y1[1] = 6500;
-            x1[2] = 500;    y1[2] = -6500;
-            x1[3] = -500;    y1[3] = -6500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 11){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = -500;      y1[0] = 7000;
-            x1[1] = 500;      y1[1] = 7000;
-            x1[2] = 500;    y1[2] = -7000;
-            x1[3] = -500;    y1[3] = -7000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 12){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = -500;      y1[0] = 7500;
-            x1[1] = 500;      y1[1] = 7500;
-            x1[2] = 500;    y1[2] = -7500;
-            x1[3] = -500;    y1[3] = -7500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-        }
-    //CLUSTERS MAP
-    if ( map == "clusters"){ 
-
-        // NFZ 1-13 ARE VERTICAL BETWEEN WESTERN CLUSTER AND EASTERN CLUSTERS
-        if ( nfz == 1){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 0;      y1[0] = 2500;
-            x1[1] = 1000;      y1[1] = 2500;
-            x1[2] = 1000;    y1[2] = -2500;
-            x1[3] = 0;    y1[3] = -2500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }        
-
-        if ( nfz == 2){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 0;      y1[0] = 3000;
-            x1[1] = 1000;      y1[1] = 3000;
-            x1[2] = 1000;    y1[2] = -3000;
-            x1[3] = 0;    y1[3] = -3000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 3){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 0;      y1[0] = 3500;
-            x1[1] = 1000;      y1[1] = 3500;
-            x1[2] = 1000;    y1[2] = -3500;
-            x1[3] = 0;    y1[3] = -3500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 4){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 0;      y1[0] = 4000;
-            x1[1] = 1000;      y1[1] = 4000;
-            x1[2] = 1000;    y1[2] = -4000;
-            x1[3] = 0;    y1[3] = -4000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 5){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 0;      y1[0] = 4500;
-            x1[1] = 1000;      y1[1] = 4500;
-            x1[2] = 1000;    y1[2] = -4500;
-            x1[3] = 0;    y1[3] = -4500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 6){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 0;      y1[0] = 5000;
-            x1[1] = 1000;      y1[1] = 5000;
-            x1[2] = 1000;    y1[2] = -5000;
-            x1[3] = 0;    y1[3] = -5000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 7){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 0;      y1[0] = 5500;
-            x1[1] = 1000;      y1[1] = 5500;
-            x1[2] = 1000;    y1[2] = -5500;
-            x1[3] = 0;    y1[3] = -5500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 8){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 0;      y1[0] = 6000;
-            x1[1] = 1000;      y1[1] = 6000;
-            x1[2] = 1000;    y1[2] = -6000;
-            x1[3] = 0;    y1[3] = -6000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 9){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 0;      y1[0] = 6500;
-            x1[1] = 1000;      y1[1] = 6500;
-            x1[2] = 1000;    y1[2] = -6500;
-            x1[3] = 0;    y1[3] = -6500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 10){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 0;      y1[0] = 7000;
-            x1[1] = 1000;      y1[1] = 7000;
-            x1[2] = 1000;    y1[2] = -7000;
-            x1[3] = 0;    y1[3] = -7000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 11){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 0;      y1[0] = 7500;
-            x1[1] = 1000;      y1[1] = 7500;
-            x1[2] = 1000;    y1[2] = -7500;
-            x1[3] = 0;    y1[3] = -7500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 12){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 0;      y1[0] = 8000;
-            x1[1] = 1000;      y1[1] = 8000;
-            x1[2] = 1000;    y1[2] = -8000;
-            x1[3] = 0;    y1[3] = -8000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 13){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 0;      y1[0] = 8500;
-            x1[1] = 1000;      y1[1] = 8500;
-            x1[2] = 1000;    y1[2] = -8500;
-            x1[3] = 0;    y1[3] = -8500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-        
-        //NFZ 14-? ARE HORIZONTAL BETWEEN NORTHERN CLUSTERS AND SOUTHERN CLUSTER
-        if ( nfz == 14){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 5000;      y1[0] = 0;
-            x1[1] = 5000;      y1[1] = -1000;
-            x1[2] = 1000;    y1[2] = -1000;
-            x1[3] = 1000;    y1[3] = 0;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 15){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 5500;      y1[0] = 0;
-            x1[1] = 5500;      y1[1] = -1000;
-            x1[2] = 500;    y1[2] = -1000;
-            x1[3] = 500;    y1[3] = 0;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }  
-
-        if ( nfz == 16){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 6000;      y1[0] = 0;
-            x1[1] = 6000;      y1[1] = -1000;
-            x1[2] = 0;    y1[2] = -1000;
-            x1[3] = 0;    y1[3] = 0;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 17){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 6500;      y1[0] = 0;
-            x1[1] = 6500;      y1[1] = -1000;
-            x1[2] = -500;    y1[2] = -1000;
-            x1[3] = -500;    y1[3] = 0;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 18){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 7000;      y1[0] = 0;
-            x1[1] = 7000;      y1[1] = -1000;
-            x1[2] = -1000;    y1[2] = -1000;
-            x1[3] = -1000;    y1[3] = 0;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 19){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 7500;      y1[0] = 0;
-            x1[1] = 7500;      y1[1] = -1000;
-            x1[2] = -1500;    y1[2] = -1000;
-            x1[3] = -1500;    y1[3] = 0;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 20){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 8000;      y1[0] = 0;
-            x1[1] = 8000;      y1[1] = -1000;
-            x1[2] = -2000;    y1[2] = -1000;
-            x1[3] = -2000;    y1[3] = 0;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 21){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 8500;      y1[0] = 0;
-            x1[1] = 8500;      y1[1] = -1000;
-            x1[2] = -2500;    y1[2] = -1000;
-            x1[3] = -2500;    y1[3] = 0;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 22){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 9000;      y1[0] = 0;
-            x1[1] = 9000;      y1[1] = -1000;
-            x1[2] = -3000;    y1[2] = -1000;
-            x1[3] = -3000;    y1[3] = 0;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 23){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 9500;      y1[0] = 0;
-            x1[1] = 9500;      y1[1] = -1000;
-            x1[2] = -3500;    y1[2] = -1000;
-            x1[3] = -3500;    y1[3] = 0;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 24){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 9500;      y1[0] = 0;
-            x1[1] = 9500;      y1[1] = -1000;
-            x1[2] = -4000;    y1[2] = -1000;
-            x1[3] = -4000;    y1[3] = 0;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 25){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 9500;      y1[0] = 0;
-            x1[1] = 9500;      y1[1] = -1000;
-            x1[2] = -4500;    y1[2] = -1000;
-            x1[3] = -4500;    y1[3] = 0;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 26){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 9500;      y1[0] = 0;
-            x1[1] = 9500;      y1[1] = -1000;
-            x1[2] = -5000;    y1[2] = -1000;
-            x1[3] = -5000;    y1[3] = 0;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        }
-
-        //GRID MAP
-    if ( map == "grid"){
-        if ( nfz == 1){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2250;      y1[0] = 2500;
-            x1[1] = 2750;      y1[1] = 2500;
-            x1[2] = 2750;    y1[2] = 500;
-            x1[3] = 2250;    y1[3] = 500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 2){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2250;      y1[0] = 2750;
-            x1[1] = 2750;      y1[1] = 2750;
-            x1[2] = 2750;    y1[2] = 250;
-            x1[3] = 2250;    y1[3] = 250;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 3){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2250;      y1[0] = 3000;
-            x1[1] = 2750;      y1[1] = 3000;
-            x1[2] = 2750;    y1[2] = 0;
-            x1[3] = 2250;    y1[3] = 0;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 4){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2250;      y1[0] = 3250;
-            x1[1] = 2750;      y1[1] = 3250;
-            x1[2] = 2750;    y1[2] = -250;
-            x1[3] = 2250;    y1[3] = -250;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 5){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2250;      y1[0] = 3500;
-            x1[1] = 2750;      y1[1] = 3500;
-            x1[2] = 2750;    y1[2] = -500;
-            x1[3] = 2250;    y1[3] = -500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 6){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2250;      y1[0] = 3750;
-            x1[1] = 2750;      y1[1] = 3750;
-            x1[2] = 2750;    y1[2] = -750;
-            x1[3] = 2250;    y1[3] = -750;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 7){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2250;      y1[0] = 4000;
-            x1[1] = 2750;      y1[1] = 4000;
-            x1[2] = 2750;    y1[2] = -1000;
-            x1[3] = 2250;    y1[3] = -1000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 8){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2250;      y1[0] = 4250;
-            x1[1] = 2750;      y1[1] = 4250;
-            x1[2] = 2750;    y1[2] = -1250;
-            x1[3] = 2250;    y1[3] = -1250;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 9){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2250;      y1[0] = 4500;
-            x1[1] = 2750;      y1[1] = 4500;
-            x1[2] = 2750;    y1[2] = -1500;
-            x1[3] = 2250;    y1[3] = -1500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 10){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2250;      y1[0] = 4750;
-            x1[1] = 2750;      y1[1] = 4750;
-            x1[2] = 2750;    y1[2] = -1750;
-            x1[3] = 2250;    y1[3] = -1750;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 11){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2250;      y1[0] = 5000;
-            x1[1] = 2750;      y1[1] = 5000;
-            x1[2] = 2750;    y1[2] = -2000;
-            x1[3] = 2250;    y1[3] = -2000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 12){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2250;      y1[0] = 5250;
-            x1[1] = 2750;      y1[1] = 5250;
-            x1[2] = 2750;    y1[2] = -2250;
-            x1[3] = 2250;    y1[3] = -2250;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-        }
-        //CIRCLE MAP
-    if ( map == "circle"){
-        if ( nfz == 1){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2200;      y1[0] = 4000;
-            x1[1] = 3200;      y1[1] = 4000;
-            x1[2] = 3200;    y1[2] = -4000;
-            x1[3] = 2200;    y1[3] = -4000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 2){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2200;      y1[0] = 4500;
-            x1[1] = 3200;      y1[1] = 4500;
-            x1[2] = 3200;    y1[2] = -4500;
-            x1[3] = 2200;    y1[3] = -4500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 3){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2200;      y1[0] = 5000;
-            x1[1] = 3200;      y1[1] = 5000;
-            x1[2] = 3200;    y1[2] = -5000;
-            x1[3] = 2200;    y1[3] = -5000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 4){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2200;      y1[0] = 5500;
-            x1[1] = 3200;      y1[1] = 5500;
-            x1[2] = 3200;    y1[2] = -5500;
-            x1[3] = 2200;    y1[3] = -5500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 5){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2200;      y1[0] = 6000;
-            x1[1] = 3200;      y1[1] = 6000;
-            x1[2] = 3200;    y1[2] = -6000;
-            x1[3] = 2200;    y1[3] = -6000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 6){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2200;      y1[0] = 6500;
-            x1[1] = 3200;      y1[1] = 6500;
-            x1[2] = 3200;    y1[2] = -6500;
-            x1[3] = 2200;    y1[3] = -6500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 7){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2200;      y1[0] = 7000;
-            x1[1] = 3200;      y1[1] = 7000;
-            x1[2] = 3200;    y1[2] = -7000;
-            x1[3] = 2200;    y1[3] = -7000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 8){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2200;      y1[0] = 7500;
-            x1[1] = 3200;      y1[1] = 7500;
-            x1[2] = 3200;    y1[2] = -7500;
-            x1[3] = 2200;    y1[3] = -7500;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 9){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2200;      y1[0] = 8000;
-            x1[1] = 3200;      y1[1] = 8000;
-            x1[2] = 3200;    y1[2] = -8000;
-            x1[3] = 2200;    y1[3] = -8000;
-
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-
-        if ( nfz == 10){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2200;      y1[0] = 8500;
-            x1[1] = 3200;      y1[1] = 8500;
-            x1[2] = 3200;    y1[2] = -8500;
-            x1[3] = 2200;    y1[3] = -8500;
 
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
+    std::cerr << "Could not load map file " << file << "\n";
 
-        if ( nfz == 11){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2200;      y1[0] = 9000;
-            x1[1] = 3200;      y1[1] = 9000;
-            x1[2] = 3200;    y1[2] = -9000;
-            x1[3] = 2200;    y1[3] = -9000;
+    //Default map boundaries (large enough to work for all map types)
+    GsPolygon pol;
+    pol.push().set( -10500.0f, -10500.0f );
+    pol.push().set( -10500.0f, 10500.0f );
+    pol.push().set( 10500.0f, 10500.0f );
+    pol.push().set( 10500.0f, -10500.0f );
+    TheLct->init(pol,0.00001f);
+}
 
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
+// *******************************************************************************
+// RESULT OUTPUT
+// *******************************************************************************
 
+/* Results are written as text (files in the command line modes, lines in the server)
+   or, after uxas_binary(true), as binary records on stdout. A record starts with a
+   16-byte header in native byte order:
+     char    tag[4]   "PATH", "LENS", "OKAY" or "ERR "
+     int32   status   PATH: 1 if a path was found, 0 otherwise; ERR : -1; others: 1
+     int32   count    PATH: number of points; LENS: number of lengths; ERR : message bytes
+     float32 len      PATH: exact path length (-1 if not found); others: 0
+   followed by count x,y float32 pairs (PATH), count float32 lengths (LENS, -1 for
+   unreachable pairs) or count characters (ERR ). A length-only reply is a PATH
+   record without points. */
+static bool Binary = false;
+
+void uxas_binary(bool b)
+{
+    Binary = b;
+# ifdef GS_WINDOWS
+    if( b ) _setmode( _fileno(stdout), _O_BINARY );
+# endif
+}
 
-        if ( nfz == 12){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2200;      y1[0] = 9500;
-            x1[1] = 3200;      y1[1] = 9500;
-            x1[2] = 3200;    y1[2] = -9500;
-            x1[3] = 2200;    y1[3] = -9500;
+static void write_record( const char* tag, int status, int count, float len, const void* data, size_t bytes )
+{
+    int header[2] = { status, count };
+    fwrite( tag, 1, 4, stdout );
+    fwrite( header, sizeof(int), 2, stdout );
+    fwrite( &len, sizeof(float), 1, stdout );
+    if( bytes>0 ) fwrite( data, 1, bytes, stdout );
+}
 
+// len is the exact path length, negative when no path was found
+static void reply_path( const GsPolygon& path, float len )
+{
+    if( Binary )
+    {
+        write_record( "PATH", len>=0? 1:0, path.size(), len>=0? len:-1.0f,
+                      path.size()? &path.cget(0):0, path.size()*sizeof(GsPnt2) );
+        return;
+    }
+    printf("path %d %d %.9g\n", len>=0? 1:0, path.size(), len>=0? len:-1.0f );
+    int k;
+    for(k=0;k<path.size();k++) printf("%.9g,%.9g\n", path[k].x, path[k].y );
+}
 
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
+// replies "<cmd> <n>" followed by the count lengths, cols per line
+static void reply_lens( const char* cmd, int n, const float* lens, int count, int cols )
+{
+    if( Binary ) { write_record( "LENS", 1, count, 0, lens, count*sizeof(float) ); return; }
+    printf("%s %d\n", cmd, n );
+    int i;
+    for(i=0;i<count;i++) printf( (i+1)%cols? "%.9g ":"%.9g\n", lens[i] );
+    if( cols==0 ) printf("\n");
+}
 
-        if ( nfz == 13){
-            int n1 = 4;
-            float x1[n1], y1[n1];
-            x1[0] = 2200;      y1[0] = 10000;
-            x1[1] = 3200;      y1[1] = 10000;
-            x1[2] = 3200;    y1[2] = -10000;
-            x1[3] = 2200;    y1[3] = -10000;
+static void reply_ok()
+{
+    if( Binary ) write_record( "OKAY", 1, 0, 0, 0, 0 ); else printf("ok\n");
+}
 
+static void reply_error( const std::string& msg )
+{
+    if( Binary ) write_record( "ERR ", -1, (int)msg.size(), 0, msg.c_str(), msg.size() );
+    else printf("error %s\n", msg.c_str() );
+}
 
-            polyID = insert_polygon_from_array(TheLct, x1, y1, n1);
-            }
-        
-        }
+// saves the constrained and unconstrained edges of the current mesh to cedges.txt and
+// ucedges.txt, as read by plot_tripath.py; verbose prints the number of edges
+static void save_mesh_edges( SeLct *TheLct, bool verbose )
+{
+    static GsArray<GsPnt2> cedges;
+    static GsArray<GsPnt2> ucedges;
+    TheLct->get_mesh_edges ( &cedges, &ucedges );
+    
+    if( verbose )
+    {
+        printf("Number of constrained edges: %d\n",cedges.size());
+        printf("Number of unconstrained edges: %d\n",ucedges.size());
+    }
+    
+    //SAVE CONSTRAINED EDGES TO FILE
+    std::ofstream cedgesFile;
+    cedgesFile.open("cedges.txt");
+    int j;
+    for(j=0;j<cedges.size();j+=2)
+    {
+        //printf("[%f,%f]\n",cedges[j].x,cedges[j].y);
+        cedgesFile << cedges[j].x << "," << cedges[j].y << ",\n";
+        cedgesFile << cedges[j+1].x << "," << cedges[j+1].y << ",\n";
+        cedgesFile << "np.NaN,np.NaN,\n";
+        // cedgesFile << "NaN,NaN,\n";
+    }
+    cedgesFile.close();        
 
+    //SAVE UNCONSTRAINED EDGES TO FILE
+    std::ofstream ucedgesFile;
+    ucedgesFile.open("ucedges.txt");        
+    for(j=0;j<ucedges.size();j+=2)
+    {
+        //printf("[%f,%f]\n",ucedges[j].x,ucedges[j].y);
+        ucedgesFile << ucedges[j].x << "," << ucedges[j].y << ",\n";
+        ucedgesFile << ucedges[j+1].x << "," << ucedges[j+1].y << ",\n";
+        ucedgesFile << "np.NaN,np.NaN,\n";
+        // ucedgesFile << "NaN,NaN,\n";
+    }
+    ucedgesFile.close();
 }
 
 static void get_path( float x1, float y1, float x2, float y2, float Radius, SeLct *TheLct,
@@ -822,44 +231,16 @@ static void get_path( float x1, float y1, float x2, float y2, float Radius, SeLc
     {
         newPath->size(0);
         newChannel->size(0);
+        if( Binary ) reply_path( *newPath, -1.0f );
+    }
+    else if( Binary )
+    {
+        //WRITE PATH RECORD TO STDOUT
+        TheLct->make_funnel_path( *newPath, Radius, GS_TORAD(10.0));
+        reply_path( *newPath, TheLct->funnel_path_length( Radius ) );
     }
     else
     {        
-        
-        static GsArray<GsPnt2> cedges;
-        static GsArray<GsPnt2> ucedges;
-        TheLct->get_mesh_edges ( &cedges, &ucedges );
-        
-        printf("Number of constrained edges: %d\n",cedges.size());
-        printf("Number of unconstrained edges: %d\n",ucedges.size());
-        
-        //SAVE CONSTRAINED EDGES TO FILE
-        std::ofstream cedgesFile;
-        cedgesFile.open("cedges.txt");
-        int j;
-        for(j=0;j<cedges.size();j+=2)
-        {
-            //printf("[%f,%f]\n",cedges[j].x,cedges[j].y);
-            cedgesFile << cedges[j].x << "," << cedges[j].y << ",\n";
-            cedgesFile << cedges[j+1].x << "," << cedges[j+1].y << ",\n";
-            cedgesFile << "np.NaN,np.NaN,\n";
-            // cedgesFile << "NaN,NaN,\n";
-        }
-        cedgesFile.close();        
-
-        //SAVE UNCONSTRAINED EDGES TO FILE
-        std::ofstream ucedgesFile;
-        ucedgesFile.open("ucedges.txt");        
-        for(j=0;j<ucedges.size();j+=2)
-        {
-            //printf("[%f,%f]\n",ucedges[j].x,ucedges[j].y);
-            ucedgesFile << ucedges[j].x << "," << ucedges[j].y << ",\n";
-            ucedgesFile << ucedges[j+1].x << "," << ucedges[j+1].y << ",\n";
-            ucedgesFile << "np.NaN,np.NaN,\n";
-            // ucedgesFile << "NaN,NaN,\n";
-        }
-        ucedgesFile.close();   
-        
         //SAVE PATH TO FILE
         printf("*****\n");
         printf("Start Point = [%f,%f]\n",x1,y1);
@@ -923,7 +304,7 @@ static int insert_heading_constraint( float xIn, float yIn, float heading, float
     return polyID;
 }
 
-void uxas_main(float xstart, float ystart, float xend, float yend, std::string map, int nfz)
+void uxas_main(float xstart, float ystart, float xend, float yend, std::string map, int nfz, float radius)
 {
     TheLct = new SeLct;
     
@@ -936,8 +317,7 @@ void uxas_main(float xstart, float ystart, float xend, float yend, std::string m
     newChannel = new GsPolygon[nPaths];
     GsPolygon *newPath;
     newPath = new GsPolygon[nPaths];
-    //Change Radius Here!
-    Radius = 85.0f;   
+    Radius = radius;
     float xK[nPaths], yK[nPaths];
     float xJ[nPaths], yJ[nPaths];
     int k;
@@ -960,3 +340,507 @@ void uxas_main(float xstart, float ystart, float xend, float yend, std::string m
     
 }
 
+// *******************************************************************************
+// SERVER MODE
+// *******************************************************************************
+
+// LCTs already built in this process, one per (map,nfz) pair, each with the
+// worker pool used for its batches (created on the first batch)
+struct LctEntry { std::string map; int nfz; SeLct* lct; SeLctBatch* batch; SeLctCache* cache; };
+static std::vector<LctEntry> LctCache;
+
+static SeLct* get_lct( std::string map, int nfz )
+{
+    for( size_t i=0; i<LctCache.size(); i++ )
+    {
+        if( LctCache[i].map==map && LctCache[i].nfz==nfz ) return LctCache[i].lct;
+    }
+    
+    LctEntry e;
+    e.map = map;
+    e.nfz = nfz;
+    e.lct = new SeLct;
+    e.batch = 0;
+    e.cache = 0;
+    create_lct_example1(e.lct, map, nfz);
+    e.lct->refine(); // build the LCT now so that the first query does not pay for it
+    LctCache.push_back(e);
+    return e.lct;
+}
+
+static SeLctBatch* get_batch( SeLct* lct )
+{
+    for( size_t i=0; i<LctCache.size(); i++ )
+    {
+        if( LctCache[i].lct!=lct ) continue;
+        if( !LctCache[i].batch ) LctCache[i].batch = new SeLctBatch( lct );
+        return LctCache[i].batch;
+    }
+    return 0;
+}
+
+// results of the single path queries of the server, which are repeated often when
+// routing between the same tasks
+static SeLctCache* get_cache( SeLct* lct )
+{
+    for( size_t i=0; i<LctCache.size(); i++ )
+    {
+        if( LctCache[i].lct!=lct ) continue;
+        if( !LctCache[i].cache ) LctCache[i].cache = new SeLctCache;
+        return LctCache[i].cache;
+    }
+    return 0;
+}
+
+// computes the landmarks of the A* heuristic, first deleting the worker pool
+// of the LCT as its query contexts would keep the previous landmark distances,
+// and the cached results as the landmarks may change the paths found
+static int set_landmarks( SeLct* lct, int n, float radius )
+{
+    for( size_t i=0; i<LctCache.size(); i++ )
+    {
+        if( LctCache[i].lct!=lct ) continue;
+        delete LctCache[i].batch;
+        LctCache[i].batch = 0;
+        if( LctCache[i].cache ) LctCache[i].cache->clear();
+    }
+    return lct->compute_landmarks( n, radius );
+}
+
+// builds or discards the junction graph, which is also shared by the pool contexts
+static int set_junction_graph( SeLct* lct, bool on )
+{
+    for( size_t i=0; i<LctCache.size(); i++ )
+    {
+        if( LctCache[i].lct!=lct ) continue;
+        delete LctCache[i].batch;
+        LctCache[i].batch = 0;
+        if( LctCache[i].cache ) LctCache[i].cache->clear();
+    }
+    if( !on ) { lct->clear_junction_graph(); return 0; }
+    return lct->compute_junction_graph();
+}
+
+// fills D (n x n, row-major) with the lengths of the paths between all pairs of points,
+// using -1 for unreachable pairs; the diagonal is zero. If paths is given it must have
+// n*n entries and receives every path as well. The n*n queries run as one batch.
+static void path_matrix( SeLct* lct, const GsArray<GsPnt2>& pts, float radius,
+                         GsArray<float>& D, GsPolygon* paths )
+{
+    int n = pts.size();
+    GsArray<SeLctBatch::Query> queries;
+    queries.size( n*n );
+    int i, j;
+    for(i=0;i<n;i++)
+    {
+        for(j=0;j<n;j++) queries[i*n+j].set( pts[i].x, pts[i].y, pts[j].x, pts[j].y, radius );
+    }
+    get_batch( lct )->run( queries, D, paths, GS_TORAD(10.0) );
+
+    for(i=0;i<n;i++) // a path from a point to itself is empty
+    {
+        D[i*n+i] = 0;
+        if( paths ) paths[i*n+i].size(0);
+    }
+}
+
+// reads queries "<x1> <y1> <x2> <y2> [radius]" from in, one per line; the
+// given radius is used when a line has only four values
+static bool read_queries( std::istream& in, float radius, GsArray<SeLctBatch::Query>& queries )
+{
+    std::string line;
+    queries.size(0);
+    while( std::getline( in, line ) )
+    {
+        std::istringstream q(line);
+        float x1, y1, x2, y2, r;
+        if( !(q >> x1) ) continue; // empty line
+        if( !(q >> y1 >> x2 >> y2) ) return false;
+        if( !(q >> r) ) r = radius;
+        queries.push().set( x1, y1, x2, y2, r );
+    }
+    return true;
+}
+
+/* setut [-radius <r>] -matrix <map> <nfz> <x1> <y1> ... <xn> <yn>
+   Computes all pairwise path lengths for the given radius with a single LCT and
+   saves them to matrix.txt, one comma-separated row per start point. */
+void uxas_matrix(std::string map, int nfz, float radius, const GsArray<GsPnt2>& pts)
+{
+    SeLct* lct = get_lct( map, nfz );
+    GsArray<float> D;
+    path_matrix( lct, pts, radius, D, 0 );
+
+    int n = pts.size();
+    if( Binary ) { reply_lens( "matrix", n, n? &D[0]:0, n*n, n ); return; }
+    std::ofstream matrixFile;
+    matrixFile.open("matrix.txt");
+    matrixFile.precision(9);
+    int i, j;
+    for(i=0;i<n;i++)
+    {
+        for(j=0;j<n;j++) matrixFile << D[i*n+j] << (j+1<n? ",":"\n");
+    }
+    matrixFile.close();
+}
+
+/* setut [-radius <r>] -batch <map> <nfz> <file>
+   Solves all queries listed in the given file, one "<x1> <y1> <x2> <y2> [radius]"
+   per line (the given radius is used if omitted), in parallel over a single LCT,
+   and saves the path lengths to batch.txt in input order, one per line (-1 if no
+   path exists). */
+void uxas_batch(std::string map, int nfz, float radius, std::string file)
+{
+    SeLct* lct = get_lct( map, nfz );
+    GsArray<SeLctBatch::Query> queries;
+    std::ifstream queriesFile( file.c_str() );
+    if( !queriesFile || !read_queries( queriesFile, radius, queries ) )
+    {
+        if( Binary ) reply_error( "could not read queries from " + file );
+        else std::cout << "Could not read queries from " << file << "\n";
+        return;
+    }
+
+    GsArray<float> lens;
+    get_batch( lct )->run( queries, lens, 0, GS_TORAD(10.0) );
+
+    if( Binary ) { reply_lens( "batch", lens.size(), lens.size()? &lens[0]:0, lens.size(), lens.size() ); return; }
+    std::ofstream batchFile;
+    batchFile.open("batch.txt");
+    batchFile.precision(9);
+    int i;
+    for(i=0;i<lens.size();i++) batchFile << lens[i] << "\n";
+    batchFile.close();
+}
+
+/* tpquery [-radius <r>] <map> <nfz> [file] [paths]
+   Solves all queries listed in the given file (or read from stdin if no file or "-"
+   is given), one "<x1> <y1> <x2> <y2> [radius]" per line (the given radius is used
+   if omitted), in parallel over a single LCT, and writes the results to stdout as
+   the reply of the server command batch. */
+void uxas_query(std::string map, int nfz, float radius, std::string file, bool withpaths)
+{
+    GsArray<SeLctBatch::Query> queries;
+    std::ifstream queriesFile;
+    if( file!="-" ) queriesFile.open( file.c_str() );
+    if( (file!="-" && !queriesFile) || !read_queries( file=="-"? std::cin:queriesFile, radius, queries ) )
+    {
+        reply_error( "could not read queries from " + file );
+        return;
+    }
+
+    SeLct* lct = get_lct( map, nfz );
+    int n = queries.size();
+    GsArray<float> lens;
+    GsPolygon* paths = withpaths? new GsPolygon[n] : 0;
+    get_batch( lct )->run( queries, lens, paths, GS_TORAD(10.0) );
+    reply_lens( "batch", n, n? &lens[0]:0, n, n );
+    if( paths )
+    {
+        int i;
+        for(i=0;i<n;i++) reply_path( paths[i], lens[i] );
+        delete[] paths;
+    }
+    fflush(stdout);
+}
+
+/* setut -snapshot <map> <nfz> <file>
+   Builds and refines the LCT of the given map and saves it as a binary snapshot,
+   which can then be given as the map of other modes: setut -matrix <file> 0 ... */
+void uxas_snapshot(std::string map, int nfz, std::string file)
+{
+    SeLct* lct = get_lct( map, nfz );
+    if( !lct->save_snapshot( file.c_str() ) ) std::cout << "Could not save snapshot " << file << "\n";
+}
+
+/* setut -mesh <map> <nfz>
+   Builds and refines the LCT of the given map and saves its edges to cedges.txt and
+   ucedges.txt for plot_tripath.py. Path queries do not write these files, so this
+   is only needed once per map and no-fly zone. */
+void uxas_mesh(std::string map, int nfz)
+{
+    save_mesh_edges( get_lct( map, nfz ), true );
+}
+
+/* setut [-radius <r>] -goals <map> <nfz> <x> <y> <x1> <y1> ... <xn> <yn>
+   Computes the path lengths for the given radius from (x,y) to all given points
+   with a single multi-goal search and saves them to goals.txt, one length per line. */
+void uxas_goals(std::string map, int nfz, float radius, float x, float y, const GsArray<GsPnt2>& pts)
+{
+    SeLct* lct = get_lct( map, nfz );
+    GsArray<float> lens;
+    lct->search_channels( x, y, pts, radius, GS_TORAD(10.0), lens );
+
+    if( Binary ) { reply_lens( "goals", lens.size(), lens.size()? &lens[0]:0, lens.size(), lens.size() ); return; }
+    std::ofstream goalsFile;
+    goalsFile.open("goals.txt");
+    goalsFile.precision(9);
+    int i;
+    for(i=0;i<lens.size();i++) goalsFile << lens[i] << "\n";
+    goalsFile.close();
+}
+
+/* Line protocol read from stdin, one reply per command written to stdout:
+     map <name> <nfz>         -> "ok" (the LCT is built only the first time a pair is used)
+     radius <r>               -> "ok", replacing the radius given to -server
+     format <text|binary>     -> "ok", already in the new format; with binary every following reply
+                                 is a binary record as described in RESULT OUTPUT
+     path <x1> <y1> <x2> <y2> -> "path <found> <npoints> <length>" followed by npoints "x,y" lines
+     length <x1> <y1> <x2> <y2>
+                              -> "length <length>" (-1 if unreachable), computed without building the path
+     matrix <n> <x1> <y1> ... <xn> <yn> [paths]
+                              -> "matrix <n>" followed by n lines of n lengths (-1 if unreachable);
+                                 with "paths" the n*n paths follow row by row, each as a "path" reply
+     goals <x> <y> <n> <x1> <y1> ... <xn> <yn> [paths]
+                              -> "goals <n>" followed by a line with the n lengths from (x,y) found in a
+                                 single multi-goal search; with "paths" the n paths follow as "path" replies
+     batch <n> [paths]        -> reads n more lines "<x1> <y1> <x2> <y2> [radius]" (the current radius is
+                                 used if omitted), solves them in parallel and replies "batch <n>" followed
+                                 by a line with the n lengths in input order; with "paths" the n paths
+                                 follow as "path" replies
+     mesh                     -> "ok" after saving the edges of the current LCT to cedges.txt and ucedges.txt
+     cache <capacity>         -> "ok" after emptying the cache of path and length results of the current LCT
+                                 and setting its maximum number of entries (4096 by default, 0 disables it)
+     radii <x1> <y1> <x2> <y2> <n> <r1> ... <rn> [paths]
+                              -> "radii <n>" followed by a line with the lengths from (x1,y1) to (x2,y2) for
+                                 each radius, larger radii than one without path not being searched; with
+                                 "paths" the n paths follow as "path" replies
+     landmarks <n> [radius]   -> "ok" after precomputing n landmarks, which speed up the single path queries
+                                 of the current LCT for any radius, those using the given radius (the current
+                                 one if omitted) or larger ones also skipping the regions from which the goal
+                                 cannot be reached (n=0 discards them)
+     junctions <0|1>          -> "ok" after building (1) or discarding (0) the junction graph of the current LCT,
+                                 which restricts single path queries to the corridors of a route
+     quit                     -> ends the server
+   Malformed or unknown commands are answered with "error <msg>". */
+void uxas_server(std::string map, int nfz, float radius)
+{
+    SeLct* lct = 0;
+    Radius = radius;
+    if( !map.empty() ) lct = get_lct( map, nfz );
+
+    GsPolygon path;
+    std::string line, cmd;
+    while( std::getline( std::cin, line ) )
+    {
+        std::istringstream in(line);
+        if( !(in >> cmd) ) continue;
+
+        if( cmd=="quit" )
+        {
+            break;
+        }
+        else if( cmd=="map" )
+        {
+            if( !(in >> map >> nfz) ) { reply_error("map expects <name> <nfz>"); }
+            else { lct = get_lct( map, nfz ); reply_ok(); }
+        }
+        else if( cmd=="format" )
+        {
+            std::string fmt;
+            if( !(in >> fmt) || (fmt!="text" && fmt!="binary") ) { reply_error("format expects text or binary"); }
+            else { uxas_binary( fmt=="binary" ); reply_ok(); }
+        }
+        else if( cmd=="radius" )
+        {
+            float r;
+            if( !(in >> r) || r<0 ) { reply_error("radius expects <r> >= 0"); }
+            else { Radius = r; reply_ok(); }
+        }
+        else if( cmd=="path" )
+        {
+            float x1, y1, x2, y2;
+            if( !(in >> x1 >> y1 >> x2 >> y2) ) { reply_error("path expects <x1> <y1> <x2> <y2>"); }
+            else if( !lct ) { reply_error("no map selected"); }
+            else
+            {
+                float len = -1.0f;
+                SeLctBatch::Query q;
+                q.set( x1, y1, x2, y2, Radius );
+                SeLctCache* cache = get_cache( lct );
+                if( !cache->get( lct->version(), q, len, &path, GS_TORAD(10.0) ) )
+                {
+                    if( lct->search_channel( x1, y1, x2, y2, Radius ) )
+                    {
+                        len = lct->funnel_path_length( Radius );
+                        lct->make_funnel_path( path, Radius, GS_TORAD(10.0) );
+                    }
+                    else path.size(0);
+                    cache->put( lct->version(), q, len, &path, GS_TORAD(10.0) );
+                }
+                reply_path( path, len );
+            }
+        }
+        else if( cmd=="length" )
+        {
+            float x1, y1, x2, y2;
+            if( !(in >> x1 >> y1 >> x2 >> y2) ) { reply_error("length expects <x1> <y1> <x2> <y2>"); }
+            else if( !lct ) { reply_error("no map selected"); }
+            else
+            {
+                float len;
+                SeLctBatch::Query q;
+                q.set( x1, y1, x2, y2, Radius );
+                SeLctCache* cache = get_cache( lct );
+                if( !cache->get( lct->version(), q, len ) )
+                {
+                    len = lct->search_channel( x1, y1, x2, y2, Radius )? lct->funnel_path_length( Radius ):-1.0f;
+                    cache->put( lct->version(), q, len );
+                }
+                if( Binary ) reply_path( GsPolygon(), len );
+                else printf("length %.9g\n", len );
+            }
+        }
+        else if( cmd=="mesh" )
+        {
+            if( !lct ) { reply_error("no map selected"); }
+            else
+            {
+                save_mesh_edges( lct, false );
+                reply_ok();
+            }
+        }
+        else if( cmd=="cache" )
+        {
+            int n;
+            if( !(in >> n) || n<0 ) { reply_error("cache expects <capacity> >= 0"); }
+            else if( !lct ) { reply_error("no map selected"); }
+            else
+            {
+                get_cache( lct )->capacity( n );
+                reply_ok();
+            }
+        }
+        else if( cmd=="landmarks" )
+        {
+            int n;
+            float r = Radius;
+            if( !(in >> n) || n<0 || ( (in >> r) && r<0 ) ) { reply_error("landmarks expects <n> >= 0 [radius >= 0]"); }
+            else if( !lct ) { reply_error("no map selected"); }
+            else
+            {
+                set_landmarks( lct, n, r );
+                reply_ok();
+            }
+        }
+        else if( cmd=="radii" )
+        {
+            float x1, y1, x2, y2;
+            int n;
+            GsArray<float> radii;
+            std::string opt;
+            if( !(in >> x1 >> y1 >> x2 >> y2 >> n) || n<0 ) { reply_error("radii expects <x1> <y1> <x2> <y2> <n> followed by n radii"); fflush(stdout); continue; }
+            radii.size(n);
+            int i;
+            for(i=0;i<n;i++) { if( !(in >> radii[i]) ) break; }
+            bool withpaths = ( in >> opt ) && opt=="paths";
+            if( i<n ) { reply_error("radii expects <x1> <y1> <x2> <y2> <n> followed by n radii"); }
+            else if( !lct ) { reply_error("no map selected"); }
+            else
+            {
+                GsArray<float> lens;
+                GsPolygon* paths = withpaths? new GsPolygon[n] : 0;
+                lct->search_radii( x1, y1, x2, y2, radii, GS_TORAD(10.0), lens, paths );
+                reply_lens( "radii", n, n? &lens[0]:0, n, n );
+                if( paths )
+                {
+                    for(i=0;i<n;i++) reply_path( paths[i], lens[i] );
+                    delete[] paths;
+                }
+            }
+        }
+        else if( cmd=="junctions" )
+        {
+            int on;
+            if( !(in >> on) || (on!=0 && on!=1) ) { reply_error("junctions expects 0 or 1"); }
+            else if( !lct ) { reply_error("no map selected"); }
+            else
+            {
+                set_junction_graph( lct, on==1 );
+                reply_ok();
+            }
+        }
+        else if( cmd=="matrix" )
+        {
+            int n;
+            GsArray<GsPnt2> pts;
+            std::string opt;
+            if( !(in >> n) || n<0 ) { reply_error("matrix expects <n> followed by n points"); fflush(stdout); continue; }
+            pts.size(n);
+            int i, j;
+            for(i=0;i<n;i++) { if( !(in >> pts[i].x >> pts[i].y) ) break; }
+            bool withpaths = ( in >> opt ) && opt=="paths";
+            if( i<n ) { reply_error("matrix expects <n> followed by n points"); }
+            else if( !lct ) { reply_error("no map selected"); }
+            else
+            {
+                GsArray<float> D;
+                GsPolygon* paths = withpaths? new GsPolygon[n*n] : 0;
+                path_matrix( lct, pts, Radius, D, paths );
+                reply_lens( "matrix", n, n? &D[0]:0, n*n, n );
+                if( paths )
+                {
+                    for(i=0;i<n*n;i++) reply_path( paths[i], D[i] );
+                    delete[] paths;
+                }
+            }
+        }
+        else if( cmd=="goals" )
+        {
+            float x, y;
+            int n;
+            GsArray<GsPnt2> pts;
+            std::string opt;
+            if( !(in >> x >> y >> n) || n<0 ) { reply_error("goals expects <x> <y> <n> followed by n points"); fflush(stdout); continue; }
+            pts.size(n);
+            int i;
+            for(i=0;i<n;i++) { if( !(in >> pts[i].x >> pts[i].y) ) break; }
+            bool withpaths = ( in >> opt ) && opt=="paths";
+            if( i<n ) { reply_error("goals expects <x> <y> <n> followed by n points"); }
+            else if( !lct ) { reply_error("no map selected"); }
+            else
+            {
+                GsArray<float> lens;
+                GsPolygon* paths = withpaths? new GsPolygon[n] : 0;
+                lct->search_channels( x, y, pts, Radius, GS_TORAD(10.0), lens, paths );
+                reply_lens( "goals", n, n? &lens[0]:0, n, n );
+                if( paths )
+                {
+                    for(i=0;i<n;i++) reply_path( paths[i], lens[i] );
+                    delete[] paths;
+                }
+            }
+        }
+        else if( cmd=="batch" )
+        {
+            int n;
+            std::string opt;
+            if( !(in >> n) || n<0 ) { reply_error("batch expects <n>"); fflush(stdout); continue; }
+            bool withpaths = ( in >> opt ) && opt=="paths";
+            std::string lines;
+            int i;
+            for(i=0;i<n && std::getline( std::cin, line );i++) lines += line + "\n";
+            std::istringstream qin(lines);
+            GsArray<SeLctBatch::Query> queries;
+            if( i<n || !read_queries( qin, Radius, queries ) || queries.size()!=n ) { reply_error("batch expects n lines <x1> <y1> <x2> <y2> [radius]"); }
+            else if( !lct ) { reply_error("no map selected"); }
+            else
+            {
+                GsArray<float> lens;
+                GsPolygon* paths = withpaths? new GsPolygon[n] : 0;
+                get_batch( lct )->run( queries, lens, paths, GS_TORAD(10.0) );
+                reply_lens( "batch", n, n? &lens[0]:0, n, n );
+                if( paths )
+                {
+                    for(i=0;i<n;i++) reply_path( paths[i], lens[i] );
+                    delete[] paths;
+                }
+            }
+        }
+        else
+        {
+            reply_error( "unknown command " + cmd );
+        }
+        fflush(stdout);
+    }
+}
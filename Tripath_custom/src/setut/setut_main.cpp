@@ -10,10 +10,20 @@
 # include <gsim/gs.h>
 # include <gsim/gs_output.h>
 # include <gsim/gs_string.h>
+# include <gsim/gs_array.h>
+# include <gsim/gs_vec2.h>
 
 //====================== Sym Edge Tutorial =====================
 
-extern void uxas_main(float xstart, float ystart, float xend, float yend, std::string map, int nfz);
+extern void uxas_main(float xstart, float ystart, float xend, float yend, std::string map, int nfz, float radius);
+extern void uxas_server(std::string map, int nfz, float radius);
+extern void uxas_matrix(std::string map, int nfz, float radius, const GsArray<GsPnt2>& pts);
+extern void uxas_goals(std::string map, int nfz, float radius, float x, float y, const GsArray<GsPnt2>& pts);
+extern void uxas_batch(std::string map, int nfz, float radius, std::string file);
+extern void uxas_map_dir(std::string exe);
+extern void uxas_snapshot(std::string map, int nfz, std::string file);
+extern void uxas_mesh(std::string map, int nfz);
+extern void uxas_binary(bool b);
 
 // int main ( int argc, char** argv )
 int main ( int argc, char** argv )
@@ -22,6 +32,64 @@ int main ( int argc, char** argv )
   std::string map;
   int nfz;
 
+  //Map files are looked up in ../maps relative to this executable (or in $SETUT_MAPS)
+  uxas_map_dir(argv[0]);
+
+  //Binary output: setut -binary <mode arguments>, results are written to stdout as binary
+  //records instead of path.txt, matrix.txt, goals.txt or batch.txt (see setut_UxAS.cpp)
+  bool binary = argc>1 && std::string(argv[1])=="-binary";
+  if ( binary ) { uxas_binary(true); argc--; argv++; }
+
+  //Clearance radius of the vehicle: setut [-binary] -radius r <mode arguments>, 85 if not given
+  float radius = 85.0f;
+  if ( argc>2 && std::string(argv[1])=="-radius" ) { radius=(float)atof(argv[2]); argc-=2; argv+=2; }
+
+  //Server mode: setut -server [map nfz], queries are then read from stdin
+  if ( argc>1 && std::string(argv[1])=="-server" )
+   { map = argc>3? argv[2] : "";
+     nfz = argc>3? atoi(argv[3]) : 0;
+     uxas_server(map, nfz, radius);
+     return 0;
+   }
+
+  //Matrix mode: setut -matrix map nfz x1 y1 ... xn yn, saves all pairwise lengths to matrix.txt
+  if ( argc>3 && std::string(argv[1])=="-matrix" )
+   { map = argv[2];
+     nfz = atoi(argv[3]);
+     GsArray<GsPnt2> pts;
+     for ( int i=4; i+1<argc; i+=2 ) pts.push().set( (float)atof(argv[i]), (float)atof(argv[i+1]) );
+     uxas_matrix(map, nfz, radius, pts);
+     return 0;
+   }
+
+  //Goals mode: setut -goals map nfz x y x1 y1 ... xn yn, saves the lengths from (x,y) to goals.txt
+  if ( argc>5 && std::string(argv[1])=="-goals" )
+   { map = argv[2];
+     nfz = atoi(argv[3]);
+     GsArray<GsPnt2> pts;
+     for ( int i=6; i+1<argc; i+=2 ) pts.push().set( (float)atof(argv[i]), (float)atof(argv[i+1]) );
+     uxas_goals(map, nfz, radius, (float)atof(argv[4]), (float)atof(argv[5]), pts);
+     return 0;
+   }
+
+  //Batch mode: setut -batch map nfz file, solves the queries in file in parallel, saves the lengths to batch.txt
+  if ( argc>4 && std::string(argv[1])=="-batch" )
+   { uxas_batch(argv[2], atoi(argv[3]), radius, argv[4]);
+     return 0;
+   }
+
+  //Snapshot mode: setut -snapshot map nfz file, saves the refined LCT to a binary file usable as map
+  if ( argc>4 && std::string(argv[1])=="-snapshot" )
+   { uxas_snapshot(argv[2], atoi(argv[3]), argv[4]);
+     return 0;
+   }
+
+  //Mesh mode: setut -mesh map nfz, saves the mesh edges to cedges.txt and ucedges.txt for plot_tripath.py
+  if ( argc>3 && std::string(argv[1])=="-mesh" )
+   { uxas_mesh(argv[2], atoi(argv[3]));
+     return 0;
+   }
+
   //Path begin/end points
   xstart = atof(argv[1]);
   ystart = atof(argv[2]);
@@ -32,8 +100,11 @@ int main ( int argc, char** argv )
   map = argv[5];
   nfz = atoi(argv[6]);
 
-  gsout << "Finding path ...\n\n";  
+  //Optional clearance radius of the vehicle, also accepted as -radius
+  if ( argc>7 ) radius = (float)atof(argv[7]);
+
+  if ( !binary ) gsout << "Finding path ...\n\n";  
   
-  uxas_main(xstart, ystart, xend, yend, map, nfz);  
+  uxas_main(xstart, ystart, xend, yend, map, nfz, radius);  
 }
 
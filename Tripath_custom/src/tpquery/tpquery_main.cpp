@@ -0,0 +1,54 @@
+/*=======================================================================
+   Copyright 2010 Marcelo Kallmann. All Rights Reserved.
+   This software is distributed for noncommercial use only, without
+   any warranties, and provided that all copies contain the full copyright
+   notice licence.txt located at the base folder of the distribution. 
+  =======================================================================*/
+
+# include <stdlib.h>
+# include <stdio.h>
+# include <string>
+
+//====================== Headless Path Queries =====================
+
+// tpquery is built from this driver, setut_UxAS.cpp and the gsim library only,
+// so that it has no OpenGL or GLUT dependency
+
+extern void uxas_server(std::string map, int nfz, float radius);
+extern void uxas_query(std::string map, int nfz, float radius, std::string file, bool withpaths);
+extern void uxas_map_dir(std::string exe);
+extern void uxas_binary(bool b);
+
+static int usage ()
+{
+  fprintf ( stderr, "usage: tpquery [-binary] [-radius r] <map> <nfz> [file|-] [paths]\n" );
+  fprintf ( stderr, "       tpquery [-binary] [-radius r] -server [map nfz]\n" );
+  return 1;
+}
+
+int main ( int argc, char** argv )
+{
+  //Map files are looked up in ../maps relative to this executable (or in $SETUT_MAPS)
+  uxas_map_dir(argv[0]);
+
+  //Binary output: results are written as the binary records described in setut_UxAS.cpp
+  if ( argc>1 && std::string(argv[1])=="-binary" ) { uxas_binary(true); argc--; argv++; }
+
+  //Clearance radius used when a query does not give one, 85 if not given
+  float radius = 85.0f;
+  if ( argc>2 && std::string(argv[1])=="-radius" ) { radius=(float)atof(argv[2]); argc-=2; argv+=2; }
+
+  //Server mode: tpquery -server [map nfz], the same line protocol as setut -server
+  if ( argc>1 && std::string(argv[1])=="-server" )
+   { uxas_server ( argc>3? argv[2]:"", argc>3? atoi(argv[3]):0, radius );
+     return 0;
+   }
+
+  //Batch mode: tpquery map nfz [file] [paths], queries are read from file or stdin, one
+  //"x1 y1 x2 y2 [radius]" per line, and all lengths (and paths) are written to stdout
+  if ( argc<3 ) return usage();
+  std::string file = argc>3? argv[3] : "-";
+  bool withpaths = argc>4 && std::string(argv[4])=="paths";
+  uxas_query ( argv[1], atoi(argv[2]), radius, file, withpaths );
+  return 0;
+}
@@ -0,0 +1,296 @@
+/*=======================================================================
+   Copyright 2010 Marcelo Kallmann. All Rights Reserved.
+   This software is distributed for noncommercial use only, without
+   any warranties, and provided that all copies contain the full copyright
+   notice licence.txt located at the base folder of the distribution. 
+  =======================================================================*/
+
+# include <string.h>
+# include <gsim/se_lct.h>
+# include <gsim/se_lct_batch.h>
+# include <gsim/se_lct_cache.h>
+# include "tripath.h"
+
+//================================ TpLct =========================================
+
+// the batch pool reads the mesh of lct, so it is deleted whenever the mesh changes;
+// the cache discards its results by itself when the mesh version changes, unless the
+// polygon edits are reported to it, and is cleared when landmarks or the junction graph
+// change as they may change the paths
+struct TpLct
+ { SeLct lct;
+   SeLctBatch* batch;
+   SeLctCache cache;
+   GsPolygon path;
+   GsArray<GsPnt2> pts;
+   GsArray<float> lens, radii;
+   GsArray<int> miss;
+   GsArray<SeLctBatch::Query> queries;
+   TpLct () { batch=0; }
+  ~TpLct () { changed(); }
+   void release () { delete batch; batch=0; }
+   void changed () { release(); cache.clear(); }
+ };
+
+enum TpGroup { TpSingle=0, TpGoals=1 }; // cache groups of single and multi-goal searches
+
+static bool endswith ( const char* s, const char* end )
+ {
+   int n=strlen(s), m=strlen(end);
+   return n>=m && strcmp(s+n-m,end)==0;
+ }
+
+//================================ C interface ===================================
+
+int tp_version ()
+ {
+   return TP_VERSION;
+ }
+
+TpLct* tp_create ( const float* xy, int n, double epsilon )
+ {
+   if ( !xy || n<3 ) return 0;
+   GsPolygon pol;
+   pol.size ( n );
+   for ( int i=0; i<n; i++ ) pol[i].set ( xy[2*i], xy[2*i+1] );
+   TpLct* t = new TpLct;
+   t->lct.init ( pol, epsilon );
+   return t;
+ }
+
+TpLct* tp_load ( const char* filename, int variant )
+ {
+   if ( !filename ) return 0;
+   TpLct* t = new TpLct;
+   bool ok;
+   if ( endswith(filename,".lct") )
+    { ok = t->lct.load_snapshot ( filename );
+    }
+   else
+    { GsInput inp;
+      ok = inp.open(filename) && t->lct.load(inp,variant);
+    }
+   if ( !ok ) { delete t; return 0; }
+   return t;
+ }
+
+int tp_save_snapshot ( TpLct* t, const char* filename )
+ {
+   return t && filename && t->lct.save_snapshot(filename)? 1:0;
+ }
+
+void tp_free ( TpLct* t )
+ {
+   delete t;
+ }
+
+int tp_insert_polygon ( TpLct* t, const float* xy, int n )
+ {
+   if ( !t || !xy || n<1 ) return -1;
+   GsPolygon pol;
+   pol.size ( n );
+   for ( int i=0; i<n; i++ ) pol[i].set ( xy[2*i], xy[2*i+1] );
+   if ( n<3 ) pol.open ( true );
+   t->release ();
+   int id = t->lct.insert_polygon ( pol );
+   t->cache.update ( t->lct.version(), pol, false );
+   return id;
+ }
+
+int tp_remove_polygon ( TpLct* t, int id )
+ {
+   if ( !t || id<=0 || !t->lct.get_polygon(id,t->path) ) return 0;
+   t->release ();
+   t->lct.remove_polygon ( id );
+   t->cache.update ( t->lct.version(), t->path, true );
+   return 1;
+ }
+
+int tp_move_polygon ( TpLct* t, int id, const float* xy, int n )
+ {
+   if ( !t || !xy || n<1 || !tp_remove_polygon(t,id) ) return -1;
+   return tp_insert_polygon ( t, xy, n );
+ }
+
+int tp_refine ( TpLct* t )
+ {
+   return t? t->lct.refine() : 0;
+ }
+
+int tp_refine_threads ( TpLct* t, int n )
+ {
+   if ( !t ) return 0;
+   t->lct.refinement_threads ( n<0? 0:n );
+   return n<0? 0:n;
+ }
+
+int tp_landmarks ( TpLct* t, int n, float radius )
+ {
+   if ( !t ) return 0;
+   t->changed (); // the pool contexts would keep the landmarks being replaced
+   return t->lct.compute_landmarks ( n, radius );
+ }
+
+int tp_junction_graph ( TpLct* t, int on )
+ {
+   if ( !t ) return 0;
+   t->changed (); // the pool contexts would keep the graph being replaced
+   if ( !on ) { t->lct.clear_junction_graph(); return 0; }
+   return t->lct.compute_junction_graph ();
+ }
+
+int tp_frozen_mesh ( TpLct* t, int on )
+ {
+   if ( !t ) return 0;
+   t->changed (); // the pool contexts would keep the copy being replaced
+   if ( !on ) { t->lct.clear_frozen_mesh(); return 0; }
+   return t->lct.compute_frozen_mesh ();
+ }
+
+int tp_search_mode ( TpLct* t, int bidirectional )
+ {
+   if ( !t ) return 0;
+   t->changed (); // the pool contexts copy the mode, and the cached channels may differ
+   t->lct.search_mode ( bidirectional? SeLct::BidirectionalSearch:SeLct::ForwardSearch );
+   return bidirectional? 1:0;
+ }
+
+int tp_expanded_nodes ( TpLct* t, int backward )
+ {
+   return t? t->lct.get_expanded_nodes(backward? true:false) : 0;
+ }
+
+float tp_path_length ( TpLct* t, float x1, float y1, float x2, float y2, float radius )
+ {
+   if ( !t ) return -1.0f;
+   SeLctBatch::Query q;
+   q.set ( x1, y1, x2, y2, radius );
+   float len;
+   if ( t->cache.get(t->lct.version(),q,len) ) return len;
+   len = t->lct.search_channel(x1,y1,x2,y2,radius)? t->lct.funnel_path_length(radius) : -1.0f;
+   t->cache.put ( t->lct.version(), q, len );
+   return len;
+ }
+
+int tp_path ( TpLct* t, float x1, float y1, float x2, float y2, float radius,
+              float dang, float* xy, int maxpts, float* len )
+ {
+   if ( len ) *len = -1.0f;
+   if ( !t || dang<=0 ) return -1;
+   SeLctBatch::Query q;
+   q.set ( x1, y1, x2, y2, radius );
+   float l;
+   if ( !t->cache.get(t->lct.version(),q,l,&t->path,dang) )
+    { if ( t->lct.search_channel(x1,y1,x2,y2,radius) )
+       { l = t->lct.funnel_path_length ( radius );
+         t->lct.make_funnel_path ( t->path, radius, dang );
+       }
+      else
+       { l = -1.0f;
+         t->path.size ( 0 );
+       }
+      t->cache.put ( t->lct.version(), q, l, &t->path, dang );
+    }
+   if ( l<0 ) return -1;
+   if ( len ) *len = l;
+   int n = t->path.size();
+   for ( int i=0; i<n && i<maxpts && xy; i++ ) { xy[2*i]=t->path[i].x; xy[2*i+1]=t->path[i].y; }
+   return n;
+ }
+
+int tp_lengths ( TpLct* t, const float* q, int n, float radius, float* lens )
+ {
+   if ( !t || n<=0 || !q || !lens ) return 0;
+   if ( !t->batch ) t->batch = new SeLctBatch ( &t->lct ); // also refines the lct
+   int i, found=0, version=t->lct.version();
+
+   // only the queries not in the cache are sent to the pool:
+   SeLctBatch::Query query;
+   t->queries.size ( 0 );
+   t->miss.size ( 0 );
+   for ( i=0; i<n; i++ )
+    { query.set ( q[4*i], q[4*i+1], q[4*i+2], q[4*i+3], radius );
+      if ( t->cache.get(version,query,lens[i]) ) { if ( lens[i]>=0 ) found++; continue; }
+      t->queries.push() = query;
+      t->miss.push() = i;
+    }
+   if ( t->queries.empty() ) return found;
+
+   found += t->batch->run ( t->queries, t->lens );
+   for ( i=0; i<t->miss.size(); i++ )
+    { lens[t->miss[i]] = t->lens[i];
+      t->cache.put ( version, t->queries[i], t->lens[i] );
+    }
+   return found;
+ }
+
+int tp_goal_lengths ( TpLct* t, float x, float y, const float* goals, int n,
+                      float radius, float* lens )
+ {
+   if ( !t || n<=0 || !goals || !lens ) return 0;
+   t->lct.refine (); // so that the version is not changed by the search
+   int i, reached=0, version=t->lct.version();
+
+   // the search expands from x,y in the same order whatever the goals are,
+   // so only the goals not in the cache are given to it:
+   SeLctBatch::Query query;
+   t->pts.size ( 0 );
+   t->miss.size ( 0 );
+   for ( i=0; i<n; i++ )
+    { query.set ( x, y, goals[2*i], goals[2*i+1], radius );
+      if ( t->cache.get(version,query,lens[i],0,0,TpGoals) ) { if ( lens[i]>=0 ) reached++; continue; }
+      t->pts.push().set ( goals[2*i], goals[2*i+1] );
+      t->miss.push() = i;
+    }
+   if ( t->pts.empty() ) return reached;
+
+   reached += t->lct.search_channels ( x, y, t->pts, radius, GS_TORAD(10.0f), t->lens );
+   for ( i=0; i<t->miss.size(); i++ )
+    { lens[t->miss[i]] = t->lens[i];
+      query.set ( x, y, t->pts[i].x, t->pts[i].y, radius );
+      t->cache.put ( version, query, t->lens[i], 0, 0, TpGoals );
+    }
+   return reached;
+ }
+
+int tp_radius_lengths ( TpLct* t, float x1, float y1, float x2, float y2, const float* radii, int n,
+                        float* lens )
+ {
+   if ( !t || n<=0 || !radii || !lens ) return 0;
+   t->lct.refine (); // so that the version is not changed by the search
+   int i, found=0, version=t->lct.version();
+
+   // the cache entries of single queries are used, but only the smallest radius is searched as a
+   // single query, the larger ones reusing its channel when they can:
+   SeLctBatch::Query query;
+   t->radii.size ( 0 );
+   t->miss.size ( 0 );
+   for ( i=0; i<n; i++ )
+    { query.set ( x1, y1, x2, y2, radii[i] );
+      if ( t->cache.get(version,query,lens[i]) ) { if ( lens[i]>=0 ) found++; continue; }
+      t->radii.push() = radii[i];
+      t->miss.push() = i;
+    }
+   if ( t->radii.empty() ) return found;
+
+   found += t->lct.search_radii ( x1, y1, x2, y2, t->radii, GS_TORAD(10.0f), t->lens );
+   float rmin = t->radii[0];
+   for ( i=1; i<t->radii.size(); i++ ) if ( t->radii[i]<rmin ) rmin=t->radii[i];
+   for ( i=0; i<t->miss.size(); i++ )
+    { lens[t->miss[i]] = t->lens[i];
+      if ( t->radii[i]!=rmin ) continue;
+      query.set ( x1, y1, x2, y2, t->radii[i] );
+      t->cache.put ( version, query, t->lens[i] );
+    }
+   return found;
+ }
+
+int tp_cache ( TpLct* t, int capacity )
+ {
+   if ( !t ) return 0;
+   int hits = t->cache.hits();
+   t->cache.capacity ( capacity );
+   return hits;
+ }
+
+//============================ End of File =================================
@@ -0,0 +1,140 @@
+/*=======================================================================
+   Copyright 2010 Marcelo Kallmann. All Rights Reserved.
+   This software is distributed for noncommercial use only, without
+   any warranties, and provided that all copies contain the full copyright
+   notice licence.txt located at the base folder of the distribution. 
+  =======================================================================*/
+
+# ifndef TRIPATH_H
+# define TRIPATH_H
+
+/** \file tripath.h
+ * C interface of libtripath, for embedding the LCT path planner in other languages
+ */
+
+# ifdef _WIN32
+# define TP_API __declspec(dllexport)
+# else
+# define TP_API __attribute__((visibility("default")))
+# endif
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+/*! Version of this interface, incremented when a function changes */
+# define TP_VERSION 1
+
+/*! Opaque handle to an LCT and its query buffers. A handle must not be used by more
+    than one thread at the same time; tp_lengths() runs its queries in parallel
+    internally. */
+typedef struct TpLct TpLct;
+
+/*! Returns TP_VERSION of the loaded library */
+TP_API int tp_version ( void );
+
+/*! Creates an LCT with the domain given by n x,y pairs. Returns null if n<3. */
+TP_API TpLct* tp_create ( const float* xy, int n, double epsilon );
+
+/*! Creates an LCT from a map file: a SeDcdt file (.dcdt) of which the given variant
+    is loaded, or a snapshot (.lct) saved with tp_save_snapshot(). Returns null if
+    the file cannot be read. */
+TP_API TpLct* tp_load ( const char* filename, int variant );
+
+/*! Saves the refined LCT as a binary snapshot. Returns 1 on success, 0 otherwise. */
+TP_API int tp_save_snapshot ( TpLct* lct, const char* filename );
+
+/*! Releases the LCT and all its buffers */
+TP_API void tp_free ( TpLct* lct );
+
+/*! Inserts a polygon obstacle of n x,y pairs (open if n<3) and returns its id,
+    or -1 if n<1 */
+TP_API int tp_insert_polygon ( TpLct* lct, const float* xy, int n );
+
+/*! Removes the polygon with the given id. Returns 1 on success, 0 if the id is not
+    valid or is the domain (id 0). */
+TP_API int tp_remove_polygon ( TpLct* lct, int id );
+
+/*! Replaces the polygon with the given id by a polygon of n x,y pairs, e.g. a no-fly
+    zone that moved, and returns the new id, or -1 if the id is not valid or n<1. */
+TP_API int tp_move_polygon ( TpLct* lct, int id, const float* xy, int n );
+
+/*! Refines the LCT if it changed since the last refinement and returns the number
+    of refinements done. Queries refine automatically, this only moves the cost. */
+TP_API int tp_refine ( TpLct* lct );
+
+/*! Sets the number of threads of the refinement and clearance passes over the whole
+    mesh, 0 using one per core. The result does not depend on it. Returns n. */
+TP_API int tp_refine_threads ( TpLct* lct, int n );
+
+/*! Precomputes n landmarks used to speed up the single path queries, and returns the
+    number of landmarks found. Their distances serve queries of any radius; queries with a
+    radius not smaller than the given one also skip the regions from which the goal cannot
+    be reached. They are discarded when polygons are inserted or removed; n=0 discards them. */
+TP_API int tp_landmarks ( TpLct* lct, int n, float radius );
+
+/*! Builds the junction graph if on is 1, or discards it if on is 0. Single path queries
+    then search only the corridors of a route between junctions. Returns the number of
+    junctions. The graph is discarded when polygons are inserted or removed. */
+TP_API int tp_junction_graph ( TpLct* lct, int on );
+
+/*! Builds the compact frozen copy of the triangulation expanded by the channel search of the
+    single path queries if on is 1, or discards it if on is 0. Queries find the same paths with
+    fewer memory accesses; the copy is kept in addition to the triangulation, which the funnel
+    still uses, and takes about 80 bytes per triangle. Returns the number of triangles. It is
+    discarded when polygons are inserted or removed. */
+TP_API int tp_frozen_mesh ( TpLct* lct, int on );
+
+/*! Makes single path queries search from both endpoints if bidirectional is 1, or only
+    from the start if it is 0 (the default). Both searches give the same kind of funnel
+    path, but the channels found may differ. Returns the mode set. */
+TP_API int tp_search_mode ( TpLct* lct, int bidirectional );
+
+/*! Returns the number of search nodes expanded from the start point by the last single
+    path query searched by lct, or from the goal point if backward is 1 */
+TP_API int tp_expanded_nodes ( TpLct* lct, int backward );
+
+/*! Returns the exact length of the path of given clearance radius from x1,y1 to
+    x2,y2, or -1 if there is no path. No path polygon is built. */
+TP_API float tp_path_length ( TpLct* lct, float x1, float y1, float x2, float y2, float radius );
+
+/*! Computes the path of given clearance radius from x1,y1 to x2,y2, with arcs
+    sampled every dang radians. Up to maxpts points are copied as x,y pairs to xy,
+    and the exact length is stored in len if not null. Returns the number of points
+    of the path, which may be larger than maxpts, or -1 if there is no path. */
+TP_API int tp_path ( TpLct* lct, float x1, float y1, float x2, float y2, float radius,
+                     float dang, float* xy, int maxpts, float* len );
+
+/*! Computes the n paths given by x1,y1,x2,y2 quadruples in q, stores their lengths
+    in lens (-1 for no path) and returns the number of paths found. The queries run
+    in parallel over a worker pool kept in the handle until the LCT changes. */
+TP_API int tp_lengths ( TpLct* lct, const float* q, int n, float radius, float* lens );
+
+/*! Computes the lengths from x,y to the n goals given as x,y pairs with a single
+    multi-goal search, stores them in lens (-1 for no path) and returns the number
+    of goals reached. */
+TP_API int tp_goal_lengths ( TpLct* lct, float x, float y, const float* goals, int n,
+                             float radius, float* lens );
+
+/*! Computes the lengths of the paths from x1,y1 to x2,y2 for each of the n given clearance
+    radii, stores them in lens (-1 for no path) and returns the number of radii with a path.
+    Radii larger than one without path are not searched, and the channel of the smallest radius
+    is reused where it is passable, which may give a path slightly longer than tp_path_length(). */
+TP_API int tp_radius_lengths ( TpLct* lct, float x1, float y1, float x2, float y2,
+                               const float* radii, int n, float* lens );
+
+/*! Query results are kept in a cache with up to 4096 entries by default, keyed by the
+    endpoints and radius, so that repeated queries do not search again. When polygons are
+    inserted, removed or moved only the results they may affect are discarded, so that
+    after a no-fly zone change only the affected queries are searched again, each one
+    from scratch as no search tree is kept. The
+    cache is emptied when landmarks or the junction graph change. This function empties
+    it and sets its capacity, with 0 disabling it, and returns the number of queries
+    answered by the cache so far. */
+TP_API int tp_cache ( TpLct* lct, int capacity );
+
+# ifdef __cplusplus
+}
+# endif
+
+# endif // TRIPATH_H
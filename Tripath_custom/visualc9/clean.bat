@@ -1,12 +0,0 @@
-rmdir /s /q obj
-
-del *.ncb
-del *.opt
-del *.plg
-del *.suo
-del *.user
-
-del /q ..\lib\*.lib
-del /q ..\bin\*.exe
-del /q ..\bin\*.ilk
-